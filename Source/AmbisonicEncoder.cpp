@@ -0,0 +1,190 @@
+/*
+  ==============================================================================
+
+    AmbisonicEncoder.cpp
+    Created: 18 Oct 2026 4:02:51am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "AmbisonicEncoder.h"
+
+namespace
+{
+    constexpr uintptr_t alignment = (uintptr_t)AmbisonicEncoder::Vec::SIMDRegisterSize;
+
+    float* alignUp(float* pointer) noexcept
+    {
+        const auto address = reinterpret_cast<uintptr_t>(pointer);
+        return reinterpret_cast<float*>((address + alignment - 1) & ~(alignment - 1));
+    }
+}
+
+void AmbisonicEncoder::prepare(int numVoicesToUse, int newOrder, int maxBlockSize, int latency)
+{
+    order = juce::jlimit(0, maxOrder, newOrder);
+    numVoices = numVoicesToUse;
+    maxSamples = maxBlockSize;
+    latencySamples = juce::jmax(0, latency);
+
+    if (order == 0)
+    {
+        gainStorage.free();
+        frameStorage.free();
+        delayLines.setSize(0, 0);
+        sources.clear();
+        added.clear();
+        addedLastBlock.clear();
+        return;
+    }
+
+    const int numChannels = getNumChannels();
+    stride = (numChannels + lanes - 1) / lanes * lanes;
+
+    gainStorage.allocate((size_t)(2 * numVoices * stride + lanes), true);
+    currentGains = alignUp(gainStorage.get());
+    targetGains = currentGains + numVoices * stride;
+
+    frameStorage.allocate((size_t)(maxSamples * stride + lanes), true);
+    frames = alignUp(frameStorage.get());
+
+    delaySize = juce::nextPowerOfTwo(latencySamples + maxSamples + 1);
+    delayLines.setSize(numChannels, delaySize);
+
+    sources.assign((size_t)numVoices, {});
+    added.assign((size_t)numVoices, 0);
+    addedLastBlock.assign((size_t)numVoices, 0);
+    reset();
+}
+
+void AmbisonicEncoder::reset() noexcept
+{
+    if (order == 0)
+        return;
+
+    // An impossible gain, so every source is worked out on its first block, and starts there
+    for (auto& source : sources)
+        source = { 0.0f, 0.0f, -1.0f };
+
+    std::fill(frames, frames + maxSamples * stride, 0.0f);
+    std::fill(added.begin(), added.end(), (juce::uint8)0);
+    std::fill(addedLastBlock.begin(), addedLastBlock.end(), (juce::uint8)0);
+    delayLines.clear();
+    delayPos = 0;
+}
+
+void AmbisonicEncoder::setSource(int voice, float azimuth, float elevation, float gain) noexcept
+{
+    auto& source = sources[(size_t)voice];
+    if (source[0] == azimuth && source[1] == elevation && source[2] == gain)
+        return;
+
+    source = { azimuth, elevation, gain };
+
+    // Ambisonics has x ahead, y to the left and z up, and counts azimuth anticlockwise
+    const float flat = std::cos(elevation);
+    float harmonics[maxChannels] = {};
+    computeHarmonics(flat * std::cos(azimuth), -flat * std::sin(azimuth), std::sin(elevation), harmonics);
+
+    auto* target = targetGains + voice * stride;
+    const int numChannels = getNumChannels();
+
+    for (int c = 0; c < numChannels; ++c)
+        target[c] = harmonics[c] * gain;
+}
+
+void AmbisonicEncoder::computeHarmonics(float x, float y, float z, float* harmonics) noexcept
+{
+    const float sqrt3 = std::sqrt(3.0f);
+    const float sqrt15 = std::sqrt(15.0f);
+    const float sqrt3over8 = std::sqrt(3.0f / 8.0f);
+    const float sqrt5over8 = std::sqrt(5.0f / 8.0f);
+
+    harmonics[0] = 1.0f;
+
+    harmonics[1] = y;
+    harmonics[2] = z;
+    harmonics[3] = x;
+
+    harmonics[4] = sqrt3 * x * y;
+    harmonics[5] = sqrt3 * y * z;
+    harmonics[6] = 0.5f * (3.0f * z * z - 1.0f);
+    harmonics[7] = sqrt3 * x * z;
+    harmonics[8] = 0.5f * sqrt3 * (x * x - y * y);
+
+    harmonics[9] = sqrt5over8 * y * (3.0f * x * x - y * y);
+    harmonics[10] = sqrt15 * x * y * z;
+    harmonics[11] = sqrt3over8 * y * (5.0f * z * z - 1.0f);
+    harmonics[12] = 0.5f * z * (5.0f * z * z - 3.0f);
+    harmonics[13] = sqrt3over8 * x * (5.0f * z * z - 1.0f);
+    harmonics[14] = 0.5f * sqrt15 * z * (x * x - y * y);
+    harmonics[15] = sqrt5over8 * x * (x * x - 3.0f * y * y);
+}
+
+void AmbisonicEncoder::addSource(int voice, const float* input, int numSamples) noexcept
+{
+    jassert(numSamples <= maxSamples);
+
+    if (order == 0 || numSamples <= 0)
+        return;
+
+    auto* current = currentGains + voice * stride;
+    const auto* target = targetGains + voice * stride;
+    const int numRegisters = stride / lanes;
+
+    if (addedLastBlock[(size_t)voice] == 0)
+        std::copy(target, target + stride, current);
+
+    added[(size_t)voice] = 1;
+
+    Vec gains[maxChannels / lanes + 1], steps[maxChannels / lanes + 1];
+    const auto perSample = Vec::expand(1.0f / (float)numSamples);
+
+    for (int r = 0; r < numRegisters; ++r)
+    {
+        gains[r] = Vec::fromRawArray(current + r * lanes);
+        steps[r] = (Vec::fromRawArray(target + r * lanes) - gains[r]) * perSample;
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto sample = Vec::expand(input[i]);
+        auto* frame = frames + i * stride;
+
+        for (int r = 0; r < numRegisters; ++r)
+        {
+            (Vec::fromRawArray(frame + r * lanes) + sample * gains[r]).copyToRawArray(frame + r * lanes);
+            gains[r] += steps[r];
+        }
+    }
+
+    std::copy(target, target + stride, current);
+}
+
+void AmbisonicEncoder::process(float* const* output, int numSamples) noexcept
+{
+    if (order == 0)
+        return;
+
+    const int mask = delaySize - 1;
+    const int numChannels = getNumChannels();
+
+    // Everything is written before it's read, so a latency shorter than the block works too
+    for (int c = 0; c < numChannels; ++c)
+    {
+        auto* line = delayLines.getWritePointer(c);
+
+        for (int i = 0; i < numSamples; ++i)
+            line[(delayPos + i) & mask] = frames[i * stride + c];
+
+        for (int i = 0; i < numSamples; ++i)
+            output[c][i] = line[(delayPos + i - latencySamples) & mask];
+    }
+
+    std::fill(frames, frames + numSamples * stride, 0.0f);
+    delayPos = (delayPos + numSamples) & mask;
+
+    std::swap(added, addedLastBlock);
+    std::fill(added.begin(), added.end(), (juce::uint8)0);
+}
@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    AmbisonicEncoder.h
+    Created: 18 Oct 2026 4:02:51am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Encodes every source into 1st to 3rd order ambisonics (ACN channel order, SN3D
+// normalisation) for installations that decode or binauralise downstream. A source
+// costs one gain per channel and sample, the spherical harmonics are only worked out
+// again when it moves, and the gains glide there over a block.
+//
+// The channels of a frame sit next to each other, so a sample is added to all of them
+// a SIMD register at a time; they're split into the output channels once per block,
+// through a delay that lines them up with the binaural output.
+class AmbisonicEncoder
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int lanes = (int)Vec::size();
+    static constexpr int maxOrder = 3;
+    static constexpr int maxChannels = (maxOrder + 1) * (maxOrder + 1);
+
+    static constexpr int getNumChannels(int order) noexcept { return (order + 1) * (order + 1); }
+
+    // order 0 turns the encoder off. latency is in samples, the delay to match.
+    void prepare(int numVoices, int order, int maxBlockSize, int latency);
+    void reset() noexcept;
+
+    int getOrder() const noexcept { return order; }
+    int getNumChannels() const noexcept { return order > 0 ? getNumChannels(order) : 0; }
+
+    // Azimuth in radians, clockwise from straight ahead as SpatialVoiceState has it,
+    // elevation up from the horizontal, and the level at the listener. The new gains are
+    // reached by the end of the next block.
+    void setSource(int voice, float azimuth, float elevation, float gain) noexcept;
+
+    // Adds numSamples of the voice's signal to every channel. A source that wasn't added
+    // last block starts at its new gains, there's nothing to glide from.
+    void addSource(int voice, const float* input, int numSamples) noexcept;
+
+    // Writes the block everything was added to into getNumChannels() channels and
+    // starts the next one
+    void process(float* const* output, int numSamples) noexcept;
+
+private:
+    // Real spherical harmonics of a direction, ACN order, SN3D
+    static void computeHarmonics(float x, float y, float z, float* harmonics) noexcept;
+
+    int order = 0;
+    int numVoices = 0;
+    int stride = 0;             // channels rounded up to whole registers
+    int maxSamples = 0;
+
+    // Per voice: the gains it is at, the ones it is heading to, and what they were worked out from
+    juce::HeapBlock<float> gainStorage;
+    float* currentGains = nullptr;
+    float* targetGains = nullptr;
+    std::vector<std::array<float, 3>> sources;
+    std::vector<juce::uint8> added, addedLastBlock;
+
+    juce::HeapBlock<float> frameStorage;
+    float* frames = nullptr;    // maxSamples frames of stride channels
+
+    juce::AudioBuffer<float> delayLines;
+    int delaySize = 0;          // power of two
+    int delayPos = 0;
+    int latencySamples = 0;
+};
@@ -0,0 +1,142 @@
+/*
+  ==============================================================================
+
+    AudioThreadGuard.cpp
+    Created: 17 Oct 2026 11:02:47am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "AudioThreadGuard.h"
+
+#if BINAURAL_RAYS_ALLOCATION_GUARD
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined (_MSC_VER)
+ #include <malloc.h>
+#endif
+
+namespace
+{
+    thread_local int guardDepth = 0;
+
+    [[noreturn]] void reportViolation(const char* what) noexcept
+    {
+        // Drop the guard first so nothing below can recurse into us
+        guardDepth = 0;
+        std::fputs("Binaural Rays: ", stderr);
+        std::fputs(what, stderr);
+        std::fputs(" called on the audio thread\n", stderr);
+        std::fflush(stderr);
+        std::abort();
+    }
+
+    void* allocate(std::size_t size, const char* what)
+    {
+        if (guardDepth > 0)
+            reportViolation(what);
+
+        if (auto* ptr = std::malloc(size == 0 ? 1 : size))
+            return ptr;
+
+        throw std::bad_alloc();
+    }
+
+    void* allocateNoThrow(std::size_t size, const char* what) noexcept
+    {
+        if (guardDepth > 0)
+            reportViolation(what);
+
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    void release(void* ptr, const char* what) noexcept
+    {
+        if (ptr == nullptr)
+            return;
+
+        if (guardDepth > 0)
+            reportViolation(what);
+
+        std::free(ptr);
+    }
+
+    // Over-aligned types (the SIMD state) come through these, freed with releaseAligned()
+    void* allocateAlignedNoThrow(std::size_t size, std::align_val_t alignment, const char* what) noexcept
+    {
+        if (guardDepth > 0)
+            reportViolation(what);
+
+        const auto bytes = size == 0 ? 1 : size;
+        const auto align = std::max(sizeof(void*), static_cast<std::size_t>(alignment));
+
+       #if defined (_MSC_VER)
+        return _aligned_malloc(bytes, align);
+       #else
+        void* ptr = nullptr;
+        return posix_memalign(&ptr, align, bytes) == 0 ? ptr : nullptr;
+       #endif
+    }
+
+    void* allocateAligned(std::size_t size, std::align_val_t alignment, const char* what)
+    {
+        if (auto* ptr = allocateAlignedNoThrow(size, alignment, what))
+            return ptr;
+
+        throw std::bad_alloc();
+    }
+
+    void releaseAligned(void* ptr, const char* what) noexcept
+    {
+        if (ptr == nullptr)
+            return;
+
+        if (guardDepth > 0)
+            reportViolation(what);
+
+       #if defined (_MSC_VER)
+        _aligned_free(ptr);
+       #else
+        std::free(ptr);
+       #endif
+    }
+}
+
+namespace AudioThreadGuard
+{
+    ScopedGuard::ScopedGuard() noexcept  { ++guardDepth; }
+    ScopedGuard::~ScopedGuard() noexcept { --guardDepth; }
+
+    bool isActive() noexcept { return guardDepth > 0; }
+}
+
+void* operator new(std::size_t size)                                   { return allocate(size, "operator new"); }
+void* operator new[](std::size_t size)                                 { return allocate(size, "operator new[]"); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept   { return allocateNoThrow(size, "operator new"); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocateNoThrow(size, "operator new[]"); }
+
+void operator delete(void* ptr) noexcept                               { release(ptr, "operator delete"); }
+void operator delete[](void* ptr) noexcept                             { release(ptr, "operator delete[]"); }
+void operator delete(void* ptr, std::size_t) noexcept                  { release(ptr, "operator delete"); }
+void operator delete[](void* ptr, std::size_t) noexcept                { release(ptr, "operator delete[]"); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept        { release(ptr, "operator delete"); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept      { release(ptr, "operator delete[]"); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)                                   { return allocateAligned(size, alignment, "operator new"); }
+void* operator new[](std::size_t size, std::align_val_t alignment)                                 { return allocateAligned(size, alignment, "operator new[]"); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept   { return allocateAlignedNoThrow(size, alignment, "operator new"); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateAlignedNoThrow(size, alignment, "operator new[]"); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept                                 { releaseAligned(ptr, "operator delete"); }
+void operator delete[](void* ptr, std::align_val_t) noexcept                               { releaseAligned(ptr, "operator delete[]"); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept                    { releaseAligned(ptr, "operator delete"); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept                  { releaseAligned(ptr, "operator delete[]"); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept          { releaseAligned(ptr, "operator delete"); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept        { releaseAligned(ptr, "operator delete[]"); }
+
+#endif
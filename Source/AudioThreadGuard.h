@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    AudioThreadGuard.h
+    Created: 17 Oct 2026 11:02:47am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+// Debug/test mode that replaces the global operator new/delete, plain, sized and
+// aligned, and aborts if any of them is called while a ScopedGuard is alive on the
+// calling thread. processBlock holds one, and so does every RealtimeWorkerPool worker
+// while it runs jobs. Enabled by default in Debug builds, define it to 0 or 1 to override.
+//
+// Only heap allocation is caught. Two locks are still taken inside processBlock, both
+// of them uncontended in steady state: juce::Synthesiser's CriticalSection around every
+// render (only the message thread's noteOn in prepareToPlay competes for it), and the
+// WaitableEvent a RealtimeWorkerPool run() signals to wake a worker that fell asleep
+// after several idle milliseconds. Anything else the audio thread hands to the message
+// thread goes through atomics the message thread polls.
+#ifndef BINAURAL_RAYS_ALLOCATION_GUARD
+ #if defined (DEBUG) || defined (_DEBUG)
+  #define BINAURAL_RAYS_ALLOCATION_GUARD 1
+ #else
+  #define BINAURAL_RAYS_ALLOCATION_GUARD 0
+ #endif
+#endif
+
+namespace AudioThreadGuard
+{
+#if BINAURAL_RAYS_ALLOCATION_GUARD
+    // Marks the calling thread as realtime until destroyed. Guards can be nested.
+    class ScopedGuard
+    {
+    public:
+        ScopedGuard() noexcept;
+        ~ScopedGuard() noexcept;
+
+        ScopedGuard(const ScopedGuard&) = delete;
+        ScopedGuard& operator=(const ScopedGuard&) = delete;
+    };
+
+    // True while the calling thread is inside a ScopedGuard
+    bool isActive() noexcept;
+#else
+    class ScopedGuard
+    {
+    public:
+        ScopedGuard() noexcept {}
+    };
+
+    inline bool isActive() noexcept { return false; }
+#endif
+}
@@ -0,0 +1,223 @@
+/*
+  ==============================================================================
+
+    BinauralBeatBank.cpp
+    Created: 18 Oct 2026 5:37:12am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "BinauralBeatBank.h"
+
+namespace
+{
+    using Vec = BinauralBeatBank::Vec;
+
+    constexpr uintptr_t alignment = (uintptr_t)Vec::SIMDRegisterSize;
+    constexpr double turn = 18446744073709551616.0;     // 2^64
+
+    float* alignUp(float* pointer) noexcept
+    {
+        const auto address = reinterpret_cast<uintptr_t>(pointer);
+        return reinterpret_cast<float*>((address + alignment - 1) & ~(alignment - 1));
+    }
+
+    // Fractions of a turn below a half, so they fit the signed range
+    juce::uint64 toFixedPoint(double turns) noexcept
+    {
+        return (juce::uint64)(juce::int64)std::llround(turns * turn);
+    }
+
+    // The phase as -0.5..0.5 of a turn
+    float toTurns(juce::uint64 phase) noexcept
+    {
+        return (float)((double)(juce::int64)phase / turn);
+    }
+
+    // sin(2 pi x) for x in -0.5..0.5: folded into -0.25..0.25, where the odd Taylor
+    // series up to the 9th power is within 4e-6
+    Vec sineOfTurns(Vec x) noexcept
+    {
+        const auto quarter = Vec::expand(0.25f);
+        const auto half = Vec::expand(0.5f);
+
+        const auto above = Vec::greaterThan(x, quarter);
+        const auto below = Vec::lessThan(x, Vec::expand(-0.25f));
+        x = x + (((half - x) - x) & above) + (((Vec::expand(-0.5f) - x) - x) & below);
+
+        const auto t = x * Vec::expand(juce::MathConstants<float>::twoPi);
+        const auto t2 = t * t;
+
+        auto result = Vec::expand(1.0f / 362880.0f);
+        result = result * t2 - Vec::expand(1.0f / 5040.0f);
+        result = result * t2 + Vec::expand(1.0f / 120.0f);
+        result = result * t2 - Vec::expand(1.0f / 6.0f);
+        result = result * t2 + Vec::expand(1.0f);
+        return result * t;
+    }
+}
+
+void BinauralBeatBank::prepare(double newSampleRate, int maxBlockSize)
+{
+    sampleRate = newSampleRate;
+    maxSamples = maxBlockSize;
+
+    constexpr int size = 2 * maxLayers;
+    storage.allocate((size_t)(4 * size + lanes), true);
+    startPhases = alignUp(storage.get());
+    phaseSteps = startPhases + size;
+    currentLevels = phaseSteps + size;
+    targetLevels = currentLevels + size;
+
+    sumStorage.allocate((size_t)(2 * maxSamples * lanes + lanes), true);
+    sums = alignUp(sumStorage.get());
+
+    increments.fill(0);
+    numLayers = numSounding = 0;
+    lastStack = {};
+    reset();
+}
+
+void BinauralBeatBank::reset() noexcept
+{
+    phases.fill(0);
+
+    if (currentLevels != nullptr)
+        std::copy(targetLevels, targetLevels + 2 * maxLayers, currentLevels);
+}
+
+void BinauralBeatBank::setLayer(int layer, double carrier, double beat, float level) noexcept
+{
+    jassert(juce::isPositiveAndBelow(layer, maxLayers));
+
+    // A layer that doesn't fit under Nyquist is muted: clamped, it would sound at the same
+    // frequency and in phase with every other one that doesn't, and add up coherently
+    if (!isAudible(carrier, beat))
+        level = 0.0f;
+
+    // Both ears stay between 0 and just under Nyquist
+    const double nyquist = getNyquist();
+    beat = juce::jlimit(0.0, nyquist, beat);
+    carrier = juce::jlimit(0.5 * beat, nyquist - 0.5 * beat, carrier);
+
+    const auto left = toFixedPoint((carrier - 0.5 * beat) / sampleRate);
+    increments[(size_t)layer] = left;
+    increments[(size_t)(maxLayers + layer)] = left + toFixedPoint(beat / sampleRate);
+
+    if (targetLevels != nullptr)
+        targetLevels[layer] = targetLevels[maxLayers + layer] = level;
+}
+
+void BinauralBeatBank::setNumLayers(int newNumLayers) noexcept
+{
+    newNumLayers = juce::jlimit(0, maxLayers, newNumLayers);
+
+    if (targetLevels != nullptr)
+        for (int layer = newNumLayers; layer < numLayers; ++layer)
+            targetLevels[layer] = targetLevels[maxLayers + layer] = 0.0f;
+
+    numLayers = newNumLayers;
+    numSounding = juce::jmax(numSounding, numLayers);
+}
+
+void BinauralBeatBank::setStack(int newNumLayers, double carrier, double beat, double spreadSemitones, float level) noexcept
+{
+    const std::array<double, 5> stack { (double)newNumLayers, carrier, beat, spreadSemitones, (double)level };
+    if (stack == lastStack)
+        return;
+
+    lastStack = stack;
+    setNumLayers(newNumLayers);
+
+    const auto layerCarrier = [&](int layer) { return carrier * std::exp2(layer * spreadSemitones / 12.0); };
+
+    // Uncorrelated sines add up in power, only the layers below Nyquist count
+    int numAudible = 0;
+    for (int layer = 0; layer < numLayers; ++layer)
+        if (isAudible(layerCarrier(layer), beat))
+            ++numAudible;
+
+    const float layerLevel = numAudible > 0 ? level / std::sqrt((float)numAudible) : 0.0f;
+
+    for (int layer = 0; layer < numLayers; ++layer)
+        setLayer(layer, layerCarrier(layer), beat, layerLevel);
+}
+
+bool BinauralBeatBank::isAudible(double carrier, double beat) const noexcept
+{
+    return carrier + 0.5 * juce::jlimit(0.0, getNyquist(), beat) <= getNyquist();
+}
+
+void BinauralBeatBank::process(float* outL, float* outR, int numSamples) noexcept
+{
+    jassert(numSamples <= maxSamples);
+
+    if (numSounding == 0 || numSamples <= 0)
+        return;
+
+    const int numRegisters = (numSounding + lanes - 1) / lanes;
+    const auto perSample = Vec::expand(1.0f / (float)numSamples);
+    const auto half = Vec::expand(0.5f);
+    const auto one = Vec::expand(1.0f);
+
+    std::fill(sums, sums + 2 * numSamples * lanes, 0.0f);
+
+    for (int ear = 0; ear < 2; ++ear)
+    {
+        const int first = ear * maxLayers;
+        auto* earSums = sums + ear * numSamples * lanes;
+
+        // Every block starts again from the exact phases
+        for (int layer = first; layer < first + numRegisters * lanes; ++layer)
+        {
+            startPhases[layer] = toTurns(phases[(size_t)layer]);
+            phaseSteps[layer] = toTurns(increments[(size_t)layer]);
+        }
+
+        for (int r = 0; r < numRegisters; ++r)
+        {
+            const int offset = first + r * lanes;
+            auto phase = Vec::fromRawArray(startPhases + offset);
+            const auto step = Vec::fromRawArray(phaseSteps + offset);
+            auto level = Vec::fromRawArray(currentLevels + offset);
+            const auto levelStep = (Vec::fromRawArray(targetLevels + offset) - level) * perSample;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto* sum = earSums + i * lanes;
+                (Vec::fromRawArray(sum) + sineOfTurns(phase) * level).copyToRawArray(sum);
+
+                // Steps are under half a turn, one wrap is always enough
+                phase += step;
+                phase -= one & Vec::greaterThanOrEqual(phase, half);
+                level += levelStep;
+            }
+        }
+    }
+
+    const auto* leftSums = sums;
+    const auto* rightSums = sums + numSamples * lanes;
+
+    if (outR != nullptr)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            outL[i] += Vec::fromRawArray(leftSums + i * lanes).sum();
+            outR[i] += Vec::fromRawArray(rightSums + i * lanes).sum();
+        }
+    }
+    else
+    {
+        for (int i = 0; i < numSamples; ++i)
+            outL[i] += 0.5f * (Vec::fromRawArray(leftSums + i * lanes) + Vec::fromRawArray(rightSums + i * lanes)).sum();
+    }
+
+    for (int layer = 0; layer < 2 * maxLayers; ++layer)
+        phases[(size_t)layer] += increments[(size_t)layer] * (juce::uint64)numSamples;
+
+    std::copy(targetLevels, targetLevels + 2 * maxLayers, currentLevels);
+
+    // Layers that were fading out are silent now
+    numSounding = numLayers;
+}
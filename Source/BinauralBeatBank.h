@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    BinauralBeatBank.h
+    Created: 18 Oct 2026 5:37:12am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Layers of binaural beats: every layer is a pair of sines, one per ear, a beat
+// frequency apart around its carrier. The ears have to get exactly their own carrier,
+// so the bank goes straight to the output, past the spatial stage.
+//
+// Phases are 64 bit fixed point, a full turn being 2^64, so they wrap for free and
+// never lose precision however long it runs. The right ear's increment is the left
+// one's plus the beat's, so the beat between them stays exact. Within a block the
+// sines are worked out in floats a SIMD register of layers at a time, starting again
+// from the exact phases every block, and the layers are summed a register at a time.
+class BinauralBeatBank
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int lanes = (int)Vec::size();
+    static constexpr int maxLayers = 64;
+
+    void prepare(double sampleRate, int maxBlockSize);
+
+    // Every layer starts again at phase 0
+    void reset() noexcept;
+
+    // Frequencies in Hz, the left ear gets carrier - beat / 2 and the right one
+    // carrier + beat / 2. Levels glide to the new one over the next block. A layer whose
+    // right ear would be above Nyquist is silent.
+    void setLayer(int layer, double carrier, double beat, float level) noexcept;
+
+    // Only the first numLayers sound, the others fade out over the next block
+    void setNumLayers(int newNumLayers) noexcept;
+    int getNumLayers() const noexcept { return numLayers; }
+
+    // numLayers layers, the carriers spreadSemitones apart upwards from carrier, all
+    // with the same beat and a level that keeps the sum of the audible ones at about level
+    void setStack(int numLayers, double carrier, double beat, double spreadSemitones, float level) noexcept;
+
+    // Adds both ears to the output, without outR the two are mixed into outL
+    void process(float* outL, float* outR, int numSamples) noexcept;
+
+private:
+    // Just under the real one, so the interpolated sines stay clear of it
+    double getNyquist() const noexcept { return 0.49 * sampleRate; }
+    bool isAudible(double carrier, double beat) const noexcept;
+
+    double sampleRate = 44100.0;
+    int maxSamples = 0;
+    int numLayers = 0;
+    int numSounding = 0;        // layers still fading out included
+    std::array<double, 5> lastStack {};
+
+    // Fixed point phases and increments, left ears then right ears
+    std::array<juce::uint64, 2 * maxLayers> phases {};
+    std::array<juce::uint64, 2 * maxLayers> increments {};
+
+    // Per block float copies of them and the levels, same layout, SIMD aligned
+    juce::HeapBlock<float> storage;
+    float* startPhases = nullptr;
+    float* phaseSteps = nullptr;
+    float* currentLevels = nullptr;
+    float* targetLevels = nullptr;
+
+    // One register of partial sums per sample and ear
+    juce::HeapBlock<float> sumStorage;
+    float* sums = nullptr;
+};
@@ -0,0 +1,32 @@
+/*
+  ==============================================================================
+
+    DelayArena.cpp
+    Created: 17 Oct 2026 9:20:14pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "DelayArena.h"
+
+void DelayArena::allocate(int ringsToAllocate, int minRingSize)
+{
+    // At least a cache line per ring, so every ring starts on one
+    numRings = ringsToAllocate;
+    ringSize = juce::nextPowerOfTwo(juce::jmax(minRingSize, (int)(alignment / sizeof(float))));
+
+    const size_t bytes = (size_t)numRings * (size_t)ringSize * sizeof(float);
+    storage.allocate(bytes + alignment, false);
+
+    const auto address = reinterpret_cast<uintptr_t>(storage.get());
+    rings = reinterpret_cast<float*>((address + alignment - 1) & ~(uintptr_t)(alignment - 1));
+
+    clear();
+}
+
+void DelayArena::clear() noexcept
+{
+    if (rings != nullptr)
+        std::fill(rings, rings + (size_t)numRings * (size_t)ringSize, 0.0f);
+}
@@ -0,0 +1,36 @@
+/*
+  ==============================================================================
+
+    DelayArena.h
+    Created: 17 Oct 2026 9:20:14pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// One allocation holding a delay ring per source. Every ring has the same power of
+// two size and starts on a cache line, so sources never share a line and a ring's
+// reads stay inside its own block of memory.
+class DelayArena
+{
+public:
+    static constexpr size_t alignment = 64;
+
+    // Allocates, call from prepareToPlay. ringSize is rounded up to a power of two.
+    void allocate(int numRings, int ringSize);
+    void clear() noexcept;
+
+    float* getRing(int index) noexcept { return rings + (size_t)index * (size_t)ringSize; }
+    int getRingSize() const noexcept { return ringSize; }
+    int getMask() const noexcept { return ringSize - 1; }
+
+private:
+    juce::HeapBlock<char> storage;
+    float* rings = nullptr;
+    int numRings = 0;
+    int ringSize = 0;
+};
@@ -0,0 +1,233 @@
+/*
+  ==============================================================================
+
+    DspProfiler.cpp
+    Created: 18 Oct 2026 2:14:37am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "DspProfiler.h"
+
+const char* DspProfiler::getStageName(Stage stage) noexcept
+{
+    switch (stage)
+    {
+        case parameters:    return "parameters";
+        case midi:          return "midi";
+        case oscillators:   return "oscillators";
+        case reverb:        return "reverb";
+        case oversampling:  return "oversampling";
+        case voices:        return "voices";
+        case ambisonics:    return "ambisonics";
+        case beats:         return "beats";
+        case block:         return "block";
+        case numStages:     break;
+    }
+
+    return "";
+}
+
+double DspProfiler::Snapshot::StageStats::getMeanMicros() const noexcept
+{
+    return count > 0 ? (double)totalNanos / (double)count / 1000.0 : 0.0;
+}
+
+double DspProfiler::Snapshot::StageStats::getPercentileMicros(double fraction) const noexcept
+{
+    juce::uint64 total = 0;
+    for (auto bucket : buckets)
+        total += bucket;
+
+    if (total == 0)
+        return 0.0;
+
+    const auto wanted = (juce::uint64)std::ceil(fraction * (double)total);
+    juce::uint64 seen = 0;
+
+    for (int b = 0; b < numBuckets; ++b)
+    {
+        seen += buckets[b];
+
+        if (seen >= wanted)
+            return (double)(1ull << (b + firstBucketShift + 1)) / 1000.0;
+    }
+
+    return (double)maxNanos / 1000.0;
+}
+
+juce::var DspProfiler::Snapshot::toVar() const
+{
+    auto* result = new juce::DynamicObject();
+    result->setProperty("enabled", isEnabled());
+    result->setProperty("blocks", (juce::int64)blocks);
+    result->setProperty("overruns", (juce::int64)overruns);
+    result->setProperty("lastLoad", lastLoad);
+    result->setProperty("peakLoad", peakLoad);
+    result->setProperty("firstBucketNs", 1 << firstBucketShift);
+
+    auto* stageResults = new juce::DynamicObject();
+
+    for (int s = 0; s < numStages; ++s)
+    {
+        const auto& stats = stages[s];
+        auto* stage = new juce::DynamicObject();
+        stage->setProperty("count", (juce::int64)stats.count);
+        stage->setProperty("meanUs", stats.getMeanMicros());
+        stage->setProperty("p50Us", stats.getPercentileMicros(0.5));
+        stage->setProperty("p99Us", stats.getPercentileMicros(0.99));
+        stage->setProperty("maxUs", (double)stats.maxNanos / 1000.0);
+        stage->setProperty("meanCycles", stats.count > 0 ? (double)stats.totalCycles / (double)stats.count : 0.0);
+
+        juce::Array<juce::var> histogram;
+        for (auto bucket : stats.buckets)
+            histogram.add((juce::int64)bucket);
+
+        stage->setProperty("histogram", histogram);
+        stageResults->setProperty(getStageName((Stage)s), juce::var(stage));
+    }
+
+    result->setProperty("stages", juce::var(stageResults));
+    return juce::var(result);
+}
+
+juce::String DspProfiler::Snapshot::toText() const
+{
+    if (!isEnabled())
+        return "Profiling not compiled in";
+
+    juce::String text;
+    text << "Load " << juce::roundToInt(lastLoad * 100.0f) << "%, peak " << juce::roundToInt(peakLoad * 100.0f)
+         << "%, " << (juce::int64)overruns << " overruns in " << (juce::int64)blocks << " blocks";
+
+    // Mean and 99th percentile per host block in microseconds, two stages a line
+    for (int s = 0; s < block; ++s)
+        text << (s % 2 == 0 ? "\n" : ", ") << getStageName((Stage)s) << " " << juce::String(stages[s].getMeanMicros(), 1)
+             << "/" << juce::String(stages[s].getPercentileMicros(0.99), 1) << " us";
+
+    return text;
+}
+
+bool DspProfiler::writeToFile(const juce::File& file) const
+{
+    return file.replaceWithText(juce::JSON::toString(getSnapshot().toVar()));
+}
+
+#if BINAURAL_RAYS_PROFILING
+
+DspProfiler::Snapshot DspProfiler::getSnapshot() const noexcept
+{
+    Snapshot snapshot;
+
+    for (int s = 0; s < numStages; ++s)
+    {
+        auto& stats = snapshot.stages[s];
+        const auto& source = counters[s];
+        stats.count = source.count.load(std::memory_order_relaxed);
+        stats.totalNanos = source.totalNanos.load(std::memory_order_relaxed);
+        stats.maxNanos = source.maxNanos.load(std::memory_order_relaxed);
+        stats.totalCycles = source.totalCycles.load(std::memory_order_relaxed);
+
+        for (int b = 0; b < numBuckets; ++b)
+            stats.buckets[b] = source.buckets[b].load(std::memory_order_relaxed);
+    }
+
+    snapshot.blocks = blocks.load(std::memory_order_relaxed);
+    snapshot.overruns = overruns.load(std::memory_order_relaxed);
+    snapshot.lastLoad = lastLoad.load(std::memory_order_relaxed);
+    snapshot.peakLoad = peakLoad.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void DspProfiler::reset() noexcept
+{
+    resetPending.store(true, std::memory_order_release);
+}
+
+void DspProfiler::beginBlock(int numSamples) noexcept
+{
+    // Clearing here keeps the audio thread the only writer
+    if (resetPending.exchange(false, std::memory_order_acquire))
+        clear();
+
+    for (int s = 0; s < numStages; ++s)
+    {
+        blockNanos[s] = 0;
+        blockCycles[s] = 0;
+        stageTimed[s] = false;
+    }
+
+    blockBudget = nanosPerSample * numSamples;
+    blockStart = now();
+    blockStartCycles = readCycles();
+}
+
+void DspProfiler::endBlock() noexcept
+{
+    const auto nanos = now() - blockStart;
+    const auto cycles = readCycles() - blockStartCycles;
+
+    // Stages that didn't run this block, like the reverb after its tail, aren't counted
+    for (int s = 0; s < block; ++s)
+        if (stageTimed[s])
+            record((Stage)s, blockNanos[s], blockCycles[s]);
+
+    record(block, nanos, cycles);
+
+    const float load = blockBudget > 0.0 ? (float)((double)nanos / blockBudget) : 0.0f;
+    lastLoad.store(load, std::memory_order_relaxed);
+
+    if (load > peakLoad.load(std::memory_order_relaxed))
+        peakLoad.store(load, std::memory_order_relaxed);
+
+    if (load > 1.0f)
+        bump(overruns, (juce::uint64)1);
+
+    bump(blocks, (juce::uint64)1);
+}
+
+void DspProfiler::record(Stage stage, juce::int64 nanos, juce::uint64 cycles) noexcept
+{
+    auto& stats = counters[stage];
+    const auto duration = (juce::uint64)juce::jmax((juce::int64)0, nanos);
+
+    bump(stats.count, (juce::uint64)1);
+    bump(stats.totalNanos, duration);
+    bump(stats.totalCycles, cycles);
+
+    if (duration > stats.maxNanos.load(std::memory_order_relaxed))
+        stats.maxNanos.store(duration, std::memory_order_relaxed);
+
+    int bucket = 0;
+    for (auto rest = duration >> (firstBucketShift + 1); rest != 0 && bucket < numBuckets - 1; rest >>= 1)
+        ++bucket;
+
+    bump(stats.buckets[bucket], (juce::uint32)1);
+}
+
+void DspProfiler::clear() noexcept
+{
+    for (auto& stats : counters)
+    {
+        stats.count.store(0, std::memory_order_relaxed);
+        stats.totalNanos.store(0, std::memory_order_relaxed);
+        stats.maxNanos.store(0, std::memory_order_relaxed);
+        stats.totalCycles.store(0, std::memory_order_relaxed);
+
+        for (auto& bucket : stats.buckets)
+            bucket.store(0, std::memory_order_relaxed);
+    }
+
+    blocks.store(0, std::memory_order_relaxed);
+    overruns.store(0, std::memory_order_relaxed);
+    lastLoad.store(0.0f, std::memory_order_relaxed);
+    peakLoad.store(0.0f, std::memory_order_relaxed);
+}
+
+#else
+
+DspProfiler::Snapshot DspProfiler::getSnapshot() const noexcept { return {}; }
+void DspProfiler::reset() noexcept {}
+
+#endif
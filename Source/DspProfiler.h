@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+    DspProfiler.h
+    Created: 18 Oct 2026 2:14:37am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <chrono>
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+// Per stage timing of processBlock. Enabled by default in Debug builds, define it to
+// 0 or 1 to override (the CMake option BINAURAL_RAYS_PROFILING turns it on for release
+// builds of the bench). When it is 0 the macro below expands to nothing and the
+// profiler has no members, so a release build carries none of it.
+#ifndef BINAURAL_RAYS_PROFILING
+ #if defined (DEBUG) || defined (_DEBUG)
+  #define BINAURAL_RAYS_PROFILING 1
+ #else
+  #define BINAURAL_RAYS_PROFILING 0
+ #endif
+#endif
+
+// Times the rest of the enclosing scope as the given stage of a DspProfiler*, which may be null
+#if BINAURAL_RAYS_PROFILING
+ #define BINAURAL_RAYS_PROFILE(profiler, stage) \
+    DspProfiler::ScopedStage JUCE_JOIN_MACRO(profiledStage, __LINE__) (profiler, DspProfiler::stage)
+#else
+ #define BINAURAL_RAYS_PROFILE(profiler, stage)
+#endif
+
+// Only the audio thread writes: every counter has one writer, so an update is a plain
+// load and store on an atomic, never a locked instruction. Any other thread can take a
+// snapshot at any time, which may be a block behind on some counters but never torn.
+//
+// Stages run once per 64-sample micro-block, and a host block holds any number of them,
+// so a stage's time is summed over the whole host block and recorded once, at the end of
+// it: every stage then counts host blocks, and compares with the same budget as the block.
+//
+// Durations go into log2 histograms, bucket b holding [2^(b + 6), 2^(b + 7)) ns, the
+// first and last also everything below and above. Blocks that take longer than the audio
+// they produce lasts are counted as overruns (xruns, if the host had no slack).
+class DspProfiler
+{
+public:
+    enum Stage
+    {
+        parameters,     // parameter smoothing, scene and geometry updates
+        midi,           // sequencer and host MIDI merge
+        oscillators,    // the synth, oscillator bank and envelopes
+        reverb,         // the send and the late reverb
+        oversampling,   // up and down around the spatial render together
+        voices,         // delays, HRIRs and reflections of every voice
+        ambisonics,     // encoding the voices for the ambisonic bus
+        beats,          // the binaural beat bank
+        block,          // the whole of processBlock
+        numStages
+    };
+
+    static constexpr int numBuckets = 24;
+    static constexpr int firstBucketShift = 6;
+
+    static const char* getStageName(Stage stage) noexcept;
+    static constexpr bool isEnabled() noexcept { return BINAURAL_RAYS_PROFILING != 0; }
+
+    // Copy of every counter, for the editor or a file
+    struct Snapshot
+    {
+        struct StageStats
+        {
+            juce::uint64 count = 0, totalNanos = 0, maxNanos = 0, totalCycles = 0;
+            juce::uint32 buckets[numBuckets] = {};
+
+            double getMeanMicros() const noexcept;
+
+            // Upper edge of the bucket the given fraction of the calls falls in
+            double getPercentileMicros(double fraction) const noexcept;
+        };
+
+        StageStats stages[numStages];
+        juce::uint64 blocks = 0, overruns = 0;
+        float lastLoad = 0.0f, peakLoad = 0.0f;     // block time over budget, 1 is an overrun
+
+        juce::var toVar() const;
+
+        // A few short lines for the editor
+        juce::String toText() const;
+    };
+
+    Snapshot getSnapshot() const noexcept;
+
+    // JSON, see Snapshot::toVar
+    bool writeToFile(const juce::File& file) const;
+
+    // Any thread. The audio thread clears the counters at the start of its next block.
+    void reset() noexcept;
+
+#if BINAURAL_RAYS_PROFILING
+    void prepare(double sampleRate) noexcept { nanosPerSample = 1.0e9 / sampleRate; }
+
+    class ScopedStage
+    {
+    public:
+        ScopedStage(DspProfiler* profilerToUse, Stage stageToTime) noexcept
+            : profiler(profilerToUse), stage(stageToTime), start(now()), startCycles(readCycles())
+        {
+        }
+
+        ~ScopedStage() noexcept
+        {
+            if (profiler != nullptr)
+                profiler->accumulate(stage, now() - start, readCycles() - startCycles);
+        }
+
+        ScopedStage(const ScopedStage&) = delete;
+        ScopedStage& operator=(const ScopedStage&) = delete;
+
+    private:
+        DspProfiler* profiler;
+        const Stage stage;
+        const juce::int64 start;
+        const juce::uint64 startCycles;
+    };
+
+    // Audio thread, around the whole block. endBlock() records every stage timed since
+    // beginBlock(), and the block itself, and checks that against the time numSamples of
+    // audio lasts.
+    void beginBlock(int numSamples) noexcept;
+    void endBlock() noexcept;
+
+private:
+    struct Counters
+    {
+        std::atomic<juce::uint64> count { 0 }, totalNanos { 0 }, maxNanos { 0 }, totalCycles { 0 };
+        std::atomic<juce::uint32> buckets[numBuckets] {};
+    };
+
+    static juce::int64 now() noexcept
+    {
+        return (juce::int64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Timestamp counter cycles where there is one, 0 elsewhere
+    static juce::uint64 readCycles() noexcept
+    {
+       #if JUCE_INTEL
+        return (juce::uint64)__rdtsc();
+       #else
+        return 0;
+       #endif
+    }
+
+    template <typename Type>
+    static void bump(std::atomic<Type>& counter, Type amount) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    // Adds to the current block's total for the stage, recorded by endBlock()
+    void accumulate(Stage stage, juce::int64 nanos, juce::uint64 cycles) noexcept
+    {
+        blockNanos[stage] += nanos;
+        blockCycles[stage] += cycles;
+        stageTimed[stage] = true;
+    }
+
+    void record(Stage stage, juce::int64 nanos, juce::uint64 cycles) noexcept;
+    void clear() noexcept;
+
+    Counters counters[numStages];
+    std::atomic<juce::uint64> blocks { 0 }, overruns { 0 };
+    std::atomic<float> lastLoad { 0.0f }, peakLoad { 0.0f };
+    std::atomic<bool> resetPending { false };
+
+    double nanosPerSample = 1.0e9 / 44100.0;
+    juce::int64 blockStart = 0;
+    juce::uint64 blockStartCycles = 0;
+    double blockBudget = 0.0;
+
+    // This block's running totals, audio thread only
+    juce::int64 blockNanos[numStages] = {};
+    juce::uint64 blockCycles[numStages] = {};
+    bool stageTimed[numStages] = {};
+#else
+    void prepare(double) noexcept {}
+    void beginBlock(int) noexcept {}
+    void endBlock() noexcept {}
+#endif
+};
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    EarlyReflections.cpp
+    Created: 17 Oct 2026 10:05:18pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "EarlyReflections.h"
+
+namespace
+{
+    using Vec = juce::dsp::SIMDRegister<float>;
+    constexpr int lanes = (int)Vec::size();
+    constexpr uintptr_t alignment = (uintptr_t)Vec::SIMDRegisterSize;
+}
+
+void EarlyReflections::setOrder(int newOrder) noexcept
+{
+    order = juce::jlimit(0, maxOrder, newOrder);
+}
+
+float EarlyReflections::getMaxPathLength(float boxSize) const noexcept
+{
+    // Image (i, j) lies in the box i boxes across and j up, so no ear inside ours is
+    // further from it than |i| + 1 boxes across and |j| + 1 up
+    float longest = 0.0f;
+
+    for (int i = 0; i <= order; ++i)
+        for (int j = 0; i + j <= order; ++j)
+            if (i + j > 0)
+                longest = juce::jmax(longest, std::sqrt((float)((i + 1) * (i + 1) + (j + 1) * (j + 1))));
+
+    return longest * boxSize;
+}
+
+void EarlyReflections::prepare(int numVoices)
+{
+    images.clear();
+
+    // Image (i, j) is i boxes across and j up. An even index is the box shifted over, an
+    // odd one is mirrored across the wall in between; |i| + |j| walls are hit on the way.
+    for (int i = -order; i <= order; ++i)
+    {
+        for (int j = -order; j <= order; ++j)
+        {
+            const int bounces = std::abs(i) + std::abs(j);
+            if (bounces == 0 || bounces > order)
+                continue;
+
+            const bool mirrorX = (i & 1) != 0, mirrorY = (j & 1) != 0;
+            images.push_back({ mirrorX ? -1.0f : 1.0f, (float)(mirrorX ? i + 1 : i),
+                               mirrorY ? -1.0f : 1.0f, (float)(mirrorY ? j + 1 : j),
+                               bounces });
+        }
+    }
+
+    jassert((int)images.size() <= maxImages);
+    bounceGains.resize(images.size());
+    setReflectivity(reflectivity);
+
+    const int numImages = getNumImages();
+    stride = (numVoices + lanes - 1) / lanes * lanes;
+    tapStorage.allocate((size_t)(numImages * numTapArrays * stride + lanes), true);
+    tapArrays.resize((size_t)(numImages * numTapArrays));
+
+    const auto address = reinterpret_cast<uintptr_t>(tapStorage.get());
+    auto* array = reinterpret_cast<float*>((address + alignment - 1) & ~(alignment - 1));
+
+    for (auto*& taps : tapArrays)
+    {
+        taps = array;
+        array += stride;
+    }
+
+    heads.assign((size_t)(numVoices * numImages * 2), {});
+}
+
+bool EarlyReflections::setReflectivity(float newReflectivity) noexcept
+{
+    newReflectivity = juce::jlimit(0.0f, 1.0f, newReflectivity);
+    const bool changed = newReflectivity != reflectivity;
+    reflectivity = newReflectivity;
+
+    for (size_t t = 0; t < images.size(); ++t)
+        bounceGains[t] = std::pow(reflectivity, (float)images[t].bounces);
+
+    return changed;
+}
+
+void EarlyReflections::getImagePositions(int image, float boxSize, const float* x, const float* y, int count,
+                                         float* imageX, float* imageY) const noexcept
+{
+    jassert(count % lanes == 0);
+
+    const auto& mirror = images[(size_t)image];
+    const auto scaleX = Vec::expand(mirror.scaleX), offsetX = Vec::expand(mirror.offsetX * boxSize);
+    const auto scaleY = Vec::expand(mirror.scaleY), offsetY = Vec::expand(mirror.offsetY * boxSize);
+
+    for (int i = 0; i < count; i += lanes)
+    {
+        (Vec::fromRawArray(x + i) * scaleX + offsetX).copyToRawArray(imageX + i);
+        (Vec::fromRawArray(y + i) * scaleY + offsetY).copyToRawArray(imageY + i);
+    }
+}
+
+void EarlyReflections::finishTaps(int image, int first, int count, float extraDelay, float maxDelay) noexcept
+{
+    jassert(count % lanes == 0 && first % lanes == 0);
+
+    const auto bounceGain = Vec::expand(bounceGains[(size_t)image]);
+    const auto extra = Vec::expand(extraDelay), ceiling = Vec::expand(maxDelay);
+    const auto zero = Vec::expand(0.0f);
+
+    for (auto array : { delayL, delayR })
+    {
+        auto* delays = getTaps(image, array) + first;
+        for (int i = 0; i < count; i += lanes)
+            Vec::min(Vec::fromRawArray(delays + i) + extra, ceiling).copyToRawArray(delays + i);
+    }
+
+    // Far images would go negative on the direct path's gain slope
+    for (auto array : { gainL, gainR })
+    {
+        auto* gains = getTaps(image, array) + first;
+        for (int i = 0; i < count; i += lanes)
+            Vec::max(Vec::fromRawArray(gains + i) * bounceGain, zero).copyToRawArray(gains + i);
+    }
+}
+
+void EarlyReflections::snap(int voice) noexcept
+{
+    const int numImages = getNumImages();
+    auto* voiceHeads = heads.data() + (size_t)(voice * numImages * 2);
+
+    for (int t = 0; t < numImages; ++t)
+    {
+        voiceHeads[t * 2] = { getTaps(t, delayL)[voice], getTaps(t, gainL)[voice], 0.0f };
+        voiceHeads[t * 2 + 1] = { getTaps(t, delayR)[voice], getTaps(t, gainR)[voice], 0.0f };
+    }
+}
+
+void EarlyReflections::process(ItdDelayEngine& reader, int voice, const float* ring, int mask, int writeStart, float* const* ears, int numSamples) noexcept
+{
+    const int numImages = getNumImages();
+    auto* voiceHeads = heads.data() + (size_t)(voice * numImages * 2);
+
+    for (int t = 0; t < numImages; ++t)
+    {
+        reader.process(ring, mask, writeStart, voiceHeads[t * 2], getTaps(t, delayL)[voice], getTaps(t, gainL)[voice], ears[0], numSamples);
+        reader.process(ring, mask, writeStart, voiceHeads[t * 2 + 1], getTaps(t, delayR)[voice], getTaps(t, gainR)[voice], ears[1], numSamples);
+    }
+}
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    EarlyReflections.h
+    Created: 17 Oct 2026 10:05:18pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ItdDelayEngine.h"
+
+// Image source early reflections off the four walls of the square box. Every wall
+// bounce of a source is a mirror image of it outside the box; the images up to the
+// chosen order are a fixed set of taps per voice, each with its own delay and gain per
+// ear, all read from the voice's one delay ring. The caller works out their ear geometry
+// (the same math as the direct path, see SpatialVoiceState) only when a source or the box
+// changes, so a block costs the same number of taps per voice whatever happens.
+//
+// The taps are read with linear interpolation, by the caller's reader, and skip the
+// HRIRs: they only carry their ITD and level differences, which is plenty for reflections.
+class EarlyReflections
+{
+public:
+    static constexpr int maxOrder = 3;
+    static constexpr int maxImages = 2 * maxOrder * (maxOrder + 1);
+
+    // distance, delay and gain per ear, one entry per voice, as in computeEars()
+    enum TapArray { distanceL, distanceR, delayL, delayR, gainL, gainR, numTapArrays };
+
+    // Takes effect on the next prepare(). 0 turns the reflections off, order n has 2n(n+1) images.
+    void setOrder(int order) noexcept;
+    int getOrder() const noexcept { return order; }
+
+    // Images of the order last prepared
+    int getNumImages() const noexcept { return (int)images.size(); }
+
+    // Longest path from inside a box of side boxSize to any image of the current order,
+    // the rings have to hold that much delay
+    float getMaxPathLength(float boxSize) const noexcept;
+
+    void prepare(int numVoices);
+
+    // Fraction of the level a wall bounce keeps. Returns true if it changed, the taps'
+    // gains have to be worked out again then.
+    bool setReflectivity(float newReflectivity) noexcept;
+    float getReflectivity() const noexcept { return reflectivity; }
+
+    // Where image number image of count positions is, for a box of side boxSize. Every
+    // pointer is SIMD aligned and count is a whole number of registers.
+    void getImagePositions(int image, float boxSize, const float* x, const float* y, int count,
+                           float* imageX, float* imageY) const noexcept;
+
+    // One of the tap arrays of an image, for the caller to fill in
+    float* getTaps(int image, TapArray array) noexcept { return tapArrays[(size_t)(image * numTapArrays + array)]; }
+
+    // Applies the bounce losses to the gains and the extra delay (e.g. the latency of the
+    // direct path's HRIRs) to the delays the caller just filled in for voices
+    // [first, first + count), count being a whole number of registers
+    void finishTaps(int image, int first, int count, float extraDelay, float maxDelay) noexcept;
+
+    // Puts every head of the voice straight on its targets
+    void snap(int voice) noexcept;
+
+    // Adds every image of the voice from its ring to both ears. reader is set to linear
+    // interpolation and prepared for the block size, one per thread rendering voices.
+    void process(ItdDelayEngine& reader, int voice, const float* ring, int mask, int writeStart,
+                 float* const* ears, int numSamples) noexcept;
+
+private:
+    // image = scale * position + offset, separately on each axis, offsets in boxes
+    struct Image
+    {
+        float scaleX, offsetX, scaleY, offsetY;
+        int bounces;
+    };
+
+    std::vector<Image> images;
+    std::vector<float> bounceGains;     // reflectivity to the power of each image's bounces
+    int order = 0;
+    float reflectivity = 0.6f;
+
+    juce::HeapBlock<float> tapStorage;
+    std::vector<float*> tapArrays;      // image major, then TapArray
+    int stride = 0;
+
+    std::vector<ItdDelayEngine::Head> heads;    // voice, image, ear
+};
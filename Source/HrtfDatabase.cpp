@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+    HrtfDatabase.cpp
+    Created: 17 Oct 2026 5:02:44pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "HrtfDatabase.h"
+#include <map>
+
+namespace
+{
+    bool isValid(const HrtfDatabase::Header& header, size_t fileSize)
+    {
+        if (std::memcmp(header.magic, "BRHT", 4) != 0 || header.version != HrtfDatabase::currentVersion)
+            return false;
+
+        if (!juce::isPowerOfTwo(header.partitionSize) || header.numHeadPartitions == 0
+            || header.numAzimuths == 0 || header.numElevations == 0)
+            return false;
+
+        const auto numFloats = (size_t)HrtfDatabase::getFilterSize(header) * 2 * header.numAzimuths * header.numElevations;
+        return fileSize >= sizeof(HrtfDatabase::Header) + numFloats * sizeof(float);
+    }
+}
+
+std::shared_ptr<const HrtfDatabase> HrtfDatabase::open(const juce::File& fileToOpen)
+{
+    static juce::CriticalSection cacheLock;
+    static std::map<juce::String, std::weak_ptr<const HrtfDatabase>> cache;
+
+    const juce::ScopedLock sl(cacheLock);
+    const auto path = fileToOpen.getFullPathName();
+
+    if (auto existing = cache[path].lock())
+        return existing;
+
+    if (!fileToOpen.existsAsFile())
+        return nullptr;
+
+    std::shared_ptr<HrtfDatabase> database(new HrtfDatabase());
+    database->file = std::make_unique<juce::MemoryMappedFile>(fileToOpen, juce::MemoryMappedFile::readOnly);
+
+    const auto* data = static_cast<const char*>(database->file->getData());
+    const auto size = database->file->getSize();
+
+    if (data == nullptr || size < sizeof(Header) || !isValid(*reinterpret_cast<const Header*>(data), size))
+        return nullptr;
+
+    database->header = reinterpret_cast<const Header*>(data);
+    database->spectra = reinterpret_cast<const float*>(data + sizeof(Header));
+    database->headSize = (int)database->header->numHeadPartitions * UniformConvolver::getSpectrumSize((int)database->header->partitionSize);
+    database->tailSize = database->getFilterSize(*database->header) - database->headSize;
+
+    cache[path] = database;
+    return database;
+}
+
+bool HrtfDatabase::write(const juce::File& fileToWrite, const Header& header, const float* data)
+{
+    const auto numFloats = (size_t)getFilterSize(header) * 2 * header.numAzimuths * header.numElevations;
+
+    fileToWrite.deleteFile();
+    juce::FileOutputStream stream(fileToWrite);
+
+    if (stream.failedToOpen())
+        return false;
+
+    return stream.write(&header, sizeof(Header)) && stream.write(data, numFloats * sizeof(float));
+}
+
+HrtfDatabase::Header HrtfDatabase::makeHeader(double sampleRate, int partitionSize, int numHeadPartitions, int numTailPartitions,
+                                              int numAzimuths, int numElevations, float elevationMin, float elevationStep)
+{
+    Header header{};
+    std::memcpy(header.magic, "BRHT", 4);
+    header.version = currentVersion;
+    header.sampleRate = (float)sampleRate;
+    header.partitionSize = (juce::uint32)partitionSize;
+    header.numHeadPartitions = (juce::uint32)numHeadPartitions;
+    header.numTailPartitions = (juce::uint32)numTailPartitions;
+    header.numAzimuths = (juce::uint32)numAzimuths;
+    header.numElevations = (juce::uint32)numElevations;
+    header.elevationMin = elevationMin;
+    header.elevationStep = elevationStep;
+    return header;
+}
+
+int HrtfDatabase::getFilterSize(const Header& header) noexcept
+{
+    // The tail's partitions are as long as the whole head
+    const int partitionSize = (int)header.partitionSize;
+    return (int)header.numHeadPartitions * UniformConvolver::getSpectrumSize(partitionSize)
+         + (int)header.numTailPartitions * UniformConvolver::getSpectrumSize(partitionSize * (int)header.numHeadPartitions);
+}
+
+bool HrtfDatabase::matches(double sampleRate, int partitionSize, int numHeadPartitions) const noexcept
+{
+    return std::abs(header->sampleRate - sampleRate) < 1.0
+        && (int)header->partitionSize == partitionSize
+        && (int)header->numHeadPartitions == numHeadPartitions;
+}
+
+const float* HrtfDatabase::getDirection(int azimuthIndex, int elevationIndex, int ear) const noexcept
+{
+    const auto index = ((size_t)elevationIndex * header->numAzimuths + (size_t)azimuthIndex) * 2 + (size_t)ear;
+    return spectra + index * (size_t)getFilterSize();
+}
+
+ConvolutionFilter HrtfDatabase::interpolate(int ear, float azimuth, float elevation, float* dest) const noexcept
+{
+    const int numAzimuths = (int)header->numAzimuths;
+    const int numElevations = (int)header->numElevations;
+
+    // Cell of the grid the direction falls in, and where in it
+    float az = juce::radiansToDegrees(azimuth) / 360.0f * (float)numAzimuths;
+    az -= std::floor(az / (float)numAzimuths) * (float)numAzimuths;
+    const int az0 = juce::jmin((int)az, numAzimuths - 1);
+    const int az1 = (az0 + 1) % numAzimuths;
+    const float azFraction = az - (float)az0;
+
+    float el = header->elevationStep > 0.0f ? (juce::radiansToDegrees(elevation) - header->elevationMin) / header->elevationStep : 0.0f;
+    el = juce::jlimit(0.0f, (float)(numElevations - 1), el);
+    const int el0 = juce::jmin((int)el, numElevations - 1);
+    const int el1 = juce::jmin(el0 + 1, numElevations - 1);
+    const float elFraction = el - (float)el0;
+
+    const int size = getFilterSize();
+    const float weights[] = { (1.0f - azFraction) * (1.0f - elFraction), azFraction * (1.0f - elFraction),
+                              (1.0f - azFraction) * elFraction, azFraction * elFraction };
+    const float* corners[] = { getDirection(az0, el0, ear), getDirection(az1, el0, ear),
+                               getDirection(az0, el1, ear), getDirection(az1, el1, ear) };
+
+    // The builder aligns every response's onset, so blending spectra doesn't comb filter
+    juce::FloatVectorOperations::copyWithMultiply(dest, corners[0], weights[0], size);
+    for (int i = 1; i < 4; ++i)
+        if (weights[i] > 0.0f)
+            juce::FloatVectorOperations::addWithMultiply(dest, corners[i], weights[i], size);
+
+    return { dest, (int)header->numHeadPartitions, dest + headSize, (int)header->numTailPartitions };
+}
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    HrtfDatabase.h
+    Created: 17 Oct 2026 5:02:44pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+#include "PartitionedConvolver.h"
+
+// Measured HRIRs, preprocessed offline (see Tools/HrtfBuilder) into the spectra
+// PartitionedConvolver consumes, and memory mapped instead of parsed: opening a set
+// costs no FFTs and no copies. Every instance in the process opening the same file
+// shares one mapping, and the OS shares its pages between processes.
+//
+// File layout, little endian:
+//   Header (64 bytes)
+//   for each elevation, for each azimuth, for each ear:
+//       numHeadPartitions head spectra, then numTailPartitions tail spectra
+// Spectra are interleaved complex bins 0..N/2 as juce::dsp::FFT's real transforms
+// produce them. Directions sit on a regular grid so a lookup is a cell index.
+class HrtfDatabase
+{
+public:
+    static constexpr juce::uint32 currentVersion = 1;
+
+    struct Header
+    {
+        char magic[4];              // "BRHT"
+        juce::uint32 version;
+        float sampleRate;
+        juce::uint32 partitionSize;
+        juce::uint32 numHeadPartitions;
+        juce::uint32 numTailPartitions;
+        juce::uint32 numAzimuths;   // from 0 degrees (ahead), clockwise, evenly spaced
+        juce::uint32 numElevations;
+        float elevationMin;         // degrees
+        float elevationStep;
+        juce::uint32 reserved[6];
+    };
+
+    static_assert(sizeof(Header) == 64, "The header is part of the file format");
+
+    // Opens the file, or returns the mapping this process already has of it.
+    // nullptr if it's missing or isn't a valid set.
+    static std::shared_ptr<const HrtfDatabase> open(const juce::File& file);
+
+    // Writes a set, spectra laid out as described above
+    static bool write(const juce::File& file, const Header& header, const float* spectra);
+
+    static Header makeHeader(double sampleRate, int partitionSize, int numHeadPartitions, int numTailPartitions,
+                             int numAzimuths, int numElevations, float elevationMin, float elevationStep);
+
+    const Header& getHeader() const noexcept { return *header; }
+
+    // Whether its partitions fit a convolver prepared with these settings
+    bool matches(double sampleRate, int partitionSize, int numHeadPartitions) const noexcept;
+
+    // Floats of one ear's filter, head and tail
+    int getFilterSize() const noexcept { return headSize + tailSize; }
+
+    // Blends the four grid directions around (azimuth, elevation), in radians, into
+    // dest (getFilterSize() floats) and returns the filter that reads it
+    ConvolutionFilter interpolate(int ear, float azimuth, float elevation, float* dest) const noexcept;
+
+    static int getFilterSize(const Header& header) noexcept;
+
+private:
+    HrtfDatabase() = default;
+
+    const float* getDirection(int azimuthIndex, int elevationIndex, int ear) const noexcept;
+
+    std::unique_ptr<juce::MemoryMappedFile> file;
+    const Header* header = nullptr;
+    const float* spectra = nullptr;
+    int headSize = 0, tailSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(HrtfDatabase)
+};
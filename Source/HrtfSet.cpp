@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    HrtfSet.cpp
+    Created: 17 Oct 2026 3:41:27pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "HrtfSet.h"
+
+namespace
+{
+    constexpr float headRadius = 0.0875f;       // meters
+    constexpr float speedOfSound = 343.0f;
+    constexpr float minAlpha = 0.1f;            // deepest shadow...
+    constexpr float minAlphaAngle = 150.0f;     // ...reached this many degrees off the ear axis
+}
+
+int HrtfSet::getPartitionSize(double sampleRate) noexcept
+{
+    int size = 8;
+    while (size * 2 <= maxLatency * sampleRate)
+        size *= 2;
+    return size;
+}
+
+void HrtfSet::prepare(double sampleRate, int partitionSize, int numHeadPartitions,
+                      std::shared_ptr<const HrtfDatabase> databaseToUse)
+{
+    if (databaseToUse != nullptr && databaseToUse->matches(sampleRate, partitionSize, numHeadPartitions))
+    {
+        database = std::move(databaseToUse);
+        filters.clear();
+        identity.buildIdentity(partitionSize);
+        return;
+    }
+
+    database = nullptr;
+    buildHeadShadowModel(sampleRate, partitionSize, numHeadPartitions);
+}
+
+void HrtfSet::buildHeadShadowModel(double sampleRate, int partitionSize, int numHeadPartitions)
+{
+    const float w0 = speedOfSound / headRadius;
+    const float fs = (float)sampleRate;
+    std::vector<float> impulse((size_t)impulseLength);
+
+    filters.clear();
+
+    for (int i = 0; i < numAngles; ++i)
+    {
+        // alpha sets the high-frequency gain: 2 facing the ear, minAlpha in its shadow
+        const float angle = 180.0f * (float)i / (float)(numAngles - 1);
+        const float alpha = (1.0f + minAlpha * 0.5f)
+            + (1.0f - minAlpha * 0.5f) * std::cos(juce::degreesToRadians(angle / minAlphaAngle * 180.0f));
+
+        // (1 + alpha s / 2w0) / (1 + s / 2w0), discretised as in the paper
+        const float a0 = w0 + fs;
+        const float a1 = (w0 - fs) / a0;
+        const float b0 = (w0 + alpha * fs) / a0;
+        const float b1 = (w0 - alpha * fs) / a0;
+
+        float previousIn = 0.0f, previousOut = 0.0f;
+
+        for (int n = 0; n < impulseLength; ++n)
+        {
+            const float in = n == 0 ? 1.0f : 0.0f;
+            const float out = b0 * in + b1 * previousIn - a1 * previousOut;
+            impulse[(size_t)n] = out;
+            previousIn = in;
+            previousOut = out;
+        }
+
+        filters.add(new ConvolutionFilterData())->build(impulse.data(), impulseLength, partitionSize, numHeadPartitions);
+    }
+
+    identity.buildIdentity(partitionSize);
+}
+
+ConvolutionFilter HrtfSet::getFilter(Ear ear, float azimuth, float elevation, float* storage) const noexcept
+{
+    if (database != nullptr)
+        return database->interpolate(ear, azimuth, elevation, storage);
+
+    if (filters.isEmpty())
+        return getIdentity();
+
+    // Angle between the source and this ear's axis, which points at -90 or +90 degrees
+    const float axis = ear == left ? -juce::MathConstants<float>::halfPi : juce::MathConstants<float>::halfPi;
+    float angle = std::abs(azimuth - axis);
+
+    if (angle > juce::MathConstants<float>::pi)
+        angle = juce::MathConstants<float>::twoPi - angle;
+
+    const int index = juce::jlimit(0, numAngles - 1,
+        juce::roundToInt(angle / juce::MathConstants<float>::pi * (float)(numAngles - 1)));
+
+    return filters.getUnchecked(index)->getFilter();
+}
@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    HrtfSet.h
+    Created: 17 Oct 2026 3:41:27pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PartitionedConvolver.h"
+#include "HrtfDatabase.h"
+
+// Table of per-ear HRIR filters, already split and transformed for PartitionedConvolver.
+// Measured responses come from an HrtfDatabase when one matching the current sample
+// rate is available. Otherwise the built-in set is a spherical head shadow model
+// (Brown & Duda): a one-pole/one-zero filter per ear whose high-frequency gain follows
+// the angle between the source and the ear's axis. Neither carries the ITD, the delay
+// rings still do that.
+class HrtfSet
+{
+public:
+    enum Ear { left = 0, right = 1 };
+
+    // Allocates, call from prepareToPlay. database may be null, or made for another
+    // sample rate, in which case the head shadow model is used.
+    void prepare(double sampleRate, int partitionSize, int numHeadPartitions,
+                 std::shared_ptr<const HrtfDatabase> database);
+
+    void buildHeadShadowModel(double sampleRate, int partitionSize, int numHeadPartitions);
+
+    // True when filters are interpolated per source, which needs getFilterSize() floats
+    // of storage for each one handed to getFilter()
+    bool isInterpolated() const noexcept { return database != nullptr; }
+    int getFilterSize() const noexcept { return database != nullptr ? database->getFilterSize() : 0; }
+
+    // azimuth in radians, 0 is straight ahead (+y), positive to the right (+x).
+    // storage is only written when isInterpolated(), and the result points into it.
+    ConvolutionFilter getFilter(Ear ear, float azimuth, float elevation, float* storage) const noexcept;
+
+    // Leaves the signal untouched, same latency as any other filter
+    ConvolutionFilter getIdentity() const noexcept { return identity.getFilter(); }
+
+    static constexpr int numAngles = 64;        // angle to the ear from 0 to 180 degrees
+    static constexpr int impulseLength = 128;
+
+    // Partitioning the convolvers are prepared with, and measured sets have to be built
+    // with (see HrtfDatabase). Partitions are the largest power of two within maxLatency,
+    // so the latency doesn't grow with the sample rate; long responses go to the tail.
+    static constexpr double maxLatency = 0.0005;
+    static constexpr int headPartitions = 8;
+    static int getPartitionSize(double sampleRate) noexcept;
+
+private:
+    std::shared_ptr<const HrtfDatabase> database;
+    juce::OwnedArray<ConvolutionFilterData> filters;   // indexed by angle to the ear
+    ConvolutionFilterData identity;
+};
@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    ItdDelayEngine.cpp
+    Created: 17 Oct 2026 12:20:15pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "ItdDelayEngine.h"
+
+namespace
+{
+    using Vec = juce::dsp::SIMDRegister<float>;
+    constexpr int vecSize = (int)Vec::size();
+
+    // 1 / prod(k - j) for j != k, the constant part of each Lagrange basis polynomial
+    template <int numPoints>
+    constexpr std::array<float, numPoints> lagrangeDenominators()
+    {
+        std::array<float, numPoints> result{};
+
+        for (int k = 0; k < numPoints; ++k)
+        {
+            float den = 1.0f;
+
+            for (int j = 0; j < numPoints; ++j)
+                if (j != k)
+                    den *= (float)(k - j);
+
+            result[k] = 1.0f / den;
+        }
+
+        return result;
+    }
+}
+
+void ItdDelayEngine::prepare(int maxBlockSize)
+{
+    maxSamples = ((maxBlockSize + vecSize - 1) / vecSize) * vecSize;
+
+    // allocate() with the extra register lets us align the start for fromRawArray
+    delayRamp.allocate((size_t)(maxSamples + vecSize), true);
+    scratch.allocate((size_t)(maxSamples + vecSize), true);
+}
+
+float ItdDelayEngine::getMinimumDelay() const noexcept
+{
+    switch (interpolation)
+    {
+        case Interpolation::lagrange3: return 2.0f;
+        case Interpolation::lagrange5: return 3.0f;
+        case Interpolation::linear:
+        case Interpolation::thiran:
+        default:                       return 1.0f;
+    }
+}
+
+void ItdDelayEngine::process(const float* ring, int mask, int writeStart, Head& head,
+                             float targetDelay, float targetGain, float* dest, int numSamples) noexcept
+{
+    jassert(numSamples <= maxSamples);
+
+    if (numSamples <= 0)
+        return;
+
+    auto* delays = Vec::getNextSIMDAlignedPtr(delayRamp.get());
+    const float step = (targetDelay - head.delay) / (float)numSamples;
+
+    for (int i = 0; i < numSamples; ++i)
+        delays[i] = head.delay + step * (float)(i + 1);
+
+    const auto* out = read(ring, mask, writeStart, head, delays, numSamples);
+
+    // Gain glides along with the delay
+    const float gainStep = (targetGain - head.gain) / (float)numSamples;
+
+    for (int i = 0; i < numSamples; ++i)
+        dest[i] += (head.gain + gainStep * (float)(i + 1)) * out[i];
+
+    head.gain = targetGain;
+}
+
+void ItdDelayEngine::process(const float* ring, int mask, int writeStart, Head& head,
+                             const float* delays, const float* gains, float* dest, int numSamples) noexcept
+{
+    jassert(numSamples <= maxSamples);
+
+    if (numSamples <= 0)
+        return;
+
+    const auto* out = read(ring, mask, writeStart, head, delays, numSamples);
+
+    for (int i = 0; i < numSamples; ++i)
+        dest[i] += gains[i] * out[i];
+
+    head.gain = gains[numSamples - 1];
+}
+
+const float* ItdDelayEngine::read(const float* ring, int mask, int writeStart, Head& head,
+                                  const float* delays, int numSamples) noexcept
+{
+    auto* out = Vec::getNextSIMDAlignedPtr(scratch.get());
+
+    switch (interpolation)
+    {
+        case Interpolation::linear:    readLagrange<2>(ring, mask, writeStart, delays, out, numSamples); break;
+        case Interpolation::lagrange3: readLagrange<4>(ring, mask, writeStart, delays, out, numSamples); break;
+        case Interpolation::lagrange5: readLagrange<6>(ring, mask, writeStart, delays, out, numSamples); break;
+        case Interpolation::thiran:    readThiran(ring, mask, writeStart, head, delays, out, numSamples); break;
+        default:                       jassertfalse; break;
+    }
+
+    head.delay = delays[numSamples - 1];
+    return out;
+}
+
+template <int numPoints>
+void ItdDelayEngine::readLagrange(const float* ring, int mask, int writeStart, const float* delays,
+                                  float* out, int numSamples) const noexcept
+{
+    // Taps sit at offsets first .. first + numPoints - 1 around the read position
+    constexpr int first = 1 - numPoints / 2;
+    static constexpr auto invDen = lagrangeDenominators<numPoints>();
+
+    const float minDelay = (float)(numPoints / 2);
+
+    alignas(Vec::SIMDRegisterSize) float fracs[vecSize];
+    alignas(Vec::SIMDRegisterSize) float taps[numPoints][vecSize];
+
+    for (int i = 0; i < numSamples; i += vecSize)
+    {
+        // Gather: the only scalar part, everything after is one register per tap
+        for (int lane = 0; lane < vecSize; ++lane)
+        {
+            const int n = juce::jmin(i + lane, numSamples - 1);
+            const float negDelay = -juce::jmax(delays[n], minDelay);
+            const float floored = std::floor(negDelay);
+            const int base = writeStart + n + (int)floored + first;
+
+            fracs[lane] = negDelay - floored;
+
+            for (int k = 0; k < numPoints; ++k)
+                taps[k][lane] = ring[(base + k) & mask];
+        }
+
+        const auto frac = Vec::fromRawArray(fracs);
+
+        Vec diffs[numPoints];
+        for (int k = 0; k < numPoints; ++k)
+            diffs[k] = frac - Vec::expand((float)(first + k));
+
+        // Each basis polynomial is the product of every diff but its own
+        Vec suffix[numPoints];
+        suffix[numPoints - 1] = Vec::expand(1.0f);
+        for (int k = numPoints - 2; k >= 0; --k)
+            suffix[k] = suffix[k + 1] * diffs[k + 1];
+
+        auto prefix = Vec::expand(1.0f);
+        auto sum = Vec::expand(0.0f);
+
+        for (int k = 0; k < numPoints; ++k)
+        {
+            sum += Vec::fromRawArray(taps[k]) * (prefix * suffix[k] * invDen[k]);
+            prefix *= diffs[k];
+        }
+
+        sum.copyToRawArray(out + i);
+    }
+}
+
+void ItdDelayEngine::readThiran(const float* ring, int mask, int writeStart, Head& head,
+                                const float* delays, float* out, int numSamples) const noexcept
+{
+    // First order Thiran allpass for the fractional part, kept in its best range
+    // (0.5 to 1.5 samples). The recursion runs sample by sample.
+    float y1 = head.allpassState;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float d = juce::jmax(delays[i], 1.0f);
+        const int integer = (int)std::floor(d - 0.5f);
+        const float fraction = d - (float)integer;
+        const float a = (1.0f - fraction) / (1.0f + fraction);
+
+        const int index = writeStart + i - integer;
+        const float x0 = ring[index & mask];
+        const float x1 = ring[(index - 1) & mask];
+
+        y1 = a * x0 + x1 - a * y1;
+        out[i] = y1;
+    }
+
+    head.allpassState = y1;
+}
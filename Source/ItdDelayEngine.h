@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    ItdDelayEngine.h
+    Created: 17 Oct 2026 12:20:15pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Fractional-delay reader for the ITD rings. The delay is ramped sample by sample
+// from its previous value to the new target across each block, so moving a source
+// glides instead of jumping, and whole blocks are interpolated at once with
+// juce::dsp::SIMDRegister instead of one popSample() per sample.
+//
+// The engine doesn't own any delay memory: it reads rings that the caller has
+// already written the current block into.
+class ItdDelayEngine
+{
+public:
+    enum class Interpolation
+    {
+        linear = 0,
+        lagrange3,
+        lagrange5,
+        thiran
+    };
+
+    // Per read head state that has to survive between blocks
+    struct Head
+    {
+        float delay = 0.0f;         // delay reached at the end of the last block, in samples
+        float gain = 0.0f;          // gain reached at the end of the last block
+        float allpassState = 0.0f;  // previous output of the Thiran allpass
+    };
+
+    void prepare(int maxBlockSize);
+
+    void setInterpolation(Interpolation newInterpolation) noexcept { interpolation = newInterpolation; }
+    Interpolation getInterpolation() const noexcept { return interpolation; }
+
+    // Smallest delay the current interpolator can read without looking past the write head
+    float getMinimumDelay() const noexcept;
+
+    // Reads numSamples from a power of two ring whose first new sample is at writeStart,
+    // ramping delay and gain from the head's state to the targets, and adds the result to dest.
+    void process(const float* ring, int mask, int writeStart, Head& head,
+                 float targetDelay, float targetGain, float* dest, int numSamples) noexcept;
+
+    // Same, but with one delay and one gain per sample supplied by the caller (e.g. a motion path)
+    void process(const float* ring, int mask, int writeStart, Head& head,
+                 const float* delays, const float* gains, float* dest, int numSamples) noexcept;
+
+private:
+    // Interpolates the ring at each delay into the scratch block and returns it
+    const float* read(const float* ring, int mask, int writeStart, Head& head, const float* delays, int numSamples) noexcept;
+
+    template <int numPoints>
+    void readLagrange(const float* ring, int mask, int writeStart, const float* delays, float* out, int numSamples) const noexcept;
+    void readThiran(const float* ring, int mask, int writeStart, Head& head, const float* delays, float* out, int numSamples) const noexcept;
+
+    Interpolation interpolation = Interpolation::lagrange3;
+
+    // Both padded up to a whole number of SIMD registers
+    juce::HeapBlock<float> delayRamp;
+    juce::HeapBlock<float> scratch;
+    int maxSamples = 0;
+};
@@ -0,0 +1,237 @@
+/*
+  ==============================================================================
+
+    LateReverb.cpp
+    Created: 17 Oct 2026 11:20:46pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "LateReverb.h"
+
+namespace
+{
+    constexpr float speedOfSound = 343.0f;
+
+    // Line lengths spread geometrically from one to this many room crossings
+    constexpr float longestLine = 3.0f;
+
+    // Sabine's constant for meters, and the least absorption we allow so the tail ends
+    constexpr double sabine = 0.161;
+    constexpr double minAbsorption = 0.02;
+
+    constexpr uintptr_t alignment = (uintptr_t)LateReverb::Vec::SIMDRegisterSize;
+
+    float* alignUp(float* pointer) noexcept
+    {
+        const auto address = reinterpret_cast<uintptr_t>(pointer);
+        return reinterpret_cast<float*>((address + alignment - 1) & ~(alignment - 1));
+    }
+
+    bool isPrime(int n) noexcept
+    {
+        if (n < 2)
+            return false;
+
+        for (int d = 2; d * d <= n; ++d)
+            if (n % d == 0)
+                return false;
+
+        return true;
+    }
+}
+
+void LateReverb::prepare(double sampleRate, int maxBlockSize, float maxRoomSize, int maxPredelay)
+{
+    currentSampleRate = sampleRate;
+
+    // A prime can land a little past the longest line
+    const int longest = (int)std::ceil(juce::jmax(maxRoomSize, minRoomSize) / speedOfSound * longestLine * sampleRate);
+    lineSize = juce::nextPowerOfTwo(longest + 64);
+    lineStorage.allocate((size_t)(maxLines * lineSize), true);
+
+    vectorStorage.allocate((size_t)(4 * maxLines + lanes), true);
+    feedbackGains = alignUp(vectorStorage.get());
+    inputSigns = feedbackGains + maxLines;
+    rightSigns = inputSigns + maxLines;
+    lineOutputs = rightSigns + maxLines;
+
+    // Two rows of a larger Hadamard matrix, so the ears get uncorrelated mixes
+    for (int k = 0; k < maxLines; ++k)
+    {
+        inputSigns[k] = (k & 2) != 0 ? -1.0f : 1.0f;
+        rightSigns[k] = (k & 1) != 0 ? -1.0f : 1.0f;
+    }
+
+    // Sylvester's construction, entry (a, b) is -1 for an odd number of common bits
+    for (int b = 0; b < lanes; ++b)
+        for (int a = 0; a < lanes; ++a)
+            innerColumns[b].set((size_t)a, (juce::countNumberOfBits((juce::uint32)(a & b)) & 1) != 0 ? -1.0f : 1.0f);
+
+    predelaySize = juce::nextPowerOfTwo(maxPredelay + maxBlockSize + 1);
+    predelayStorage.allocate((size_t)predelaySize, true);
+
+    updateLines();
+    reset();
+}
+
+void LateReverb::reset() noexcept
+{
+    if (lineStorage != nullptr)
+        std::fill(lineStorage.get(), lineStorage.get() + maxLines * lineSize, 0.0f);
+
+    if (predelayStorage != nullptr)
+        std::fill(predelayStorage.get(), predelayStorage.get() + predelaySize, 0.0f);
+
+    writePos = 0;
+    predelayPos = 0;
+}
+
+void LateReverb::setNumLines(int newNumLines) noexcept
+{
+    newNumLines = newNumLines > 8 ? 16 : 8;
+    if (newNumLines == numLines)
+        return;
+
+    numLines = newNumLines;
+    updateLines();
+    reset();
+}
+
+void LateReverb::setRoom(float roomSize, float reflectivity, int predelay) noexcept
+{
+    roomSize = juce::jmax(roomSize, minRoomSize);
+    predelay = juce::jlimit(0, juce::jmax(0, predelaySize - 1), predelay);
+
+    if (roomSize == room && reflectivity == wallReflectivity && predelay == predelaySamples)
+        return;
+
+    room = roomSize;
+    wallReflectivity = reflectivity;
+    predelaySamples = predelay;
+    updateLines();
+}
+
+double LateReverb::getDecayTime(float roomSize, float reflectivity) noexcept
+{
+    // A cube of side roomSize: volume over surface is a sixth of the side. The walls
+    // absorb whatever energy they don't reflect.
+    const double absorption = juce::jmax(minAbsorption, 1.0 - (double)reflectivity * reflectivity);
+    return sabine * juce::jmax(roomSize, minRoomSize) / (6.0 * absorption);
+}
+
+void LateReverb::updateLines() noexcept
+{
+    if (lineSize == 0)
+        return;
+
+    // Prime lengths never share a period, so the echoes don't pile up on each other
+    const double crossing = room / speedOfSound * currentSampleRate;
+    const double decayTime = getDecayTime(room, wallReflectivity);
+    const float normalisation = 1.0f / std::sqrt((float)numLines);
+    int previous = 0;
+
+    for (int k = 0; k < maxLines; ++k)
+    {
+        if (k >= numLines)
+        {
+            feedbackGains[k] = 0.0f;
+            continue;
+        }
+
+        int length = (int)(crossing * std::pow((double)longestLine, (double)k / (numLines - 1)));
+        length = juce::jmax(length, previous + 1);
+
+        while (!isPrime(length) && length < lineSize - 1)
+            ++length;
+
+        lengths[k] = previous = juce::jmin(length, lineSize - 1);
+
+        // Every pass through a line loses its share of 60 dB over the decay time
+        feedbackGains[k] = normalisation * (float)std::pow(10.0, -3.0 * lengths[k] / (decayTime * currentSampleRate));
+    }
+}
+
+void LateReverb::process(const float* send, float* outL, float* outR, int numSamples) noexcept
+{
+    jassert(numSamples < predelaySize);
+
+    const int predelayMask = predelaySize - 1;
+    const int firstPart = juce::jmin(numSamples, predelaySize - predelayPos);
+    std::copy(send, send + firstPart, predelayStorage.get() + predelayPos);
+    std::copy(send + firstPart, send + numSamples, predelayStorage.get());
+
+    const int mask = lineSize - 1;
+    const int numRegisters = numLines / lanes;
+    const float normalisation = 1.0f / std::sqrt((float)numLines);
+    auto* lines = lineStorage.get();
+
+    Vec mixed[maxLines / lanes];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float input = predelayStorage[(size_t)((predelayPos + i - predelaySamples) & predelayMask)] * normalisation;
+
+        for (int k = 0; k < numLines; ++k)
+            lineOutputs[k] = lines[k * lineSize + ((writePos - lengths[k]) & mask)];
+
+        auto left = Vec::expand(0.0f), right = Vec::expand(0.0f);
+
+        // Within each register, by the columns of the small matrix
+        for (int r = 0; r < numRegisters; ++r)
+        {
+            const auto* outputs = lineOutputs + r * lanes;
+            const auto x = Vec::fromRawArray(outputs);
+            left += x;
+            right += x * Vec::fromRawArray(rightSigns + r * lanes);
+
+            const auto decayed = x * Vec::fromRawArray(feedbackGains + r * lanes);
+            auto sum = Vec::expand(0.0f);
+
+            for (int j = 0; j < lanes; ++j)
+                sum += innerColumns[j] * decayed.get((size_t)j);
+
+            mixed[r] = sum;
+        }
+
+        // Across registers, a fast Walsh-Hadamard transform of whole registers
+        for (int h = 1; h < numRegisters; h *= 2)
+        {
+            for (int r = 0; r < numRegisters; r += h * 2)
+            {
+                for (int j = r; j < r + h; ++j)
+                {
+                    const auto a = mixed[j], b = mixed[j + h];
+                    mixed[j] = a + b;
+                    mixed[j + h] = a - b;
+                }
+            }
+        }
+
+        const auto in = Vec::expand(input);
+
+        for (int r = 0; r < numRegisters; ++r)
+            (mixed[r] + in * Vec::fromRawArray(inputSigns + r * lanes)).copyToRawArray(lineOutputs + r * lanes);
+
+        for (int k = 0; k < numLines; ++k)
+            lines[k * lineSize + writePos] = lineOutputs[k];
+
+        writePos = (writePos + 1) & mask;
+
+        const float wetL = left.sum() * normalisation;
+        const float wetR = right.sum() * normalisation;
+
+        if (outR != nullptr)
+        {
+            outL[i] += wetL;
+            outR[i] += wetR;
+        }
+        else
+        {
+            outL[i] += 0.5f * (wetL + wetR);
+        }
+    }
+
+    predelayPos = (predelayPos + numSamples) & predelayMask;
+}
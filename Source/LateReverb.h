@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    LateReverb.h
+    Created: 17 Oct 2026 11:20:46pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Diffuse tail of the box: a feedback delay network of 8 or 16 lines fed by one mono
+// send shared by every source, so it costs the same however many are sounding. Line
+// lengths grow with the room, and its decay time follows from the room and how much
+// the walls reflect (Sabine). The lines are mixed by a Hadamard matrix a SIMD register
+// at a time: within a register by its columns, across registers by butterflies.
+class LateReverb
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int lanes = (int)Vec::size();
+    static constexpr int maxLines = 16;
+    static_assert(8 % lanes == 0, "a register has to hold whole groups of the smallest network");
+
+    // Rooms smaller than this would ring, they all sound like this one
+    static constexpr float minRoomSize = 1.0f;
+
+    // maxPredelay is in samples
+    void prepare(double sampleRate, int maxBlockSize, float maxRoomSize, int maxPredelay);
+    void reset() noexcept;
+
+    // 8 or 16, clears the tail when it changes
+    void setNumLines(int numLines) noexcept;
+
+    // Room size in meters and the fraction of the level a wall bounce keeps, the new
+    // lengths and gains take over at once. The tail starts predelay samples after the send.
+    void setRoom(float roomSize, float reflectivity, int predelay) noexcept;
+
+    // Seconds for the tail of such a room to fall by 60 dB
+    static double getDecayTime(float roomSize, float reflectivity) noexcept;
+
+    // Feeds numSamples of the send into the network and adds its output to both channels.
+    // Without outR the two are mixed into outL.
+    void process(const float* send, float* outL, float* outR, int numSamples) noexcept;
+
+private:
+    void updateLines() noexcept;
+
+    double currentSampleRate = 44100.0;
+    int numLines = 8;
+    float room = minRoomSize;
+    float wallReflectivity = 0.6f;
+
+    juce::HeapBlock<float> lineStorage;     // maxLines rings of lineSize, one after the other
+    int lineSize = 0;                       // power of two
+    int writePos = 0;
+    int lengths[maxLines] = {};
+
+    // Per line feedback gain (decay and matrix normalisation folded in), input and
+    // output signs, and the scratch the lines are read into, all SIMD aligned
+    juce::HeapBlock<float> vectorStorage;
+    float* feedbackGains = nullptr;
+    float* inputSigns = nullptr;
+    float* rightSigns = nullptr;
+    float* lineOutputs = nullptr;
+
+    // Columns of the lanes x lanes Hadamard matrix
+    Vec innerColumns[lanes];
+
+    juce::HeapBlock<float> predelayStorage;
+    int predelaySize = 0;                   // power of two
+    int predelayPos = 0;
+    int predelaySamples = 0;
+};
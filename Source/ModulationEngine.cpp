@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+    ModulationEngine.cpp
+    Created: 17 Oct 2026 8:34:52pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "ModulationEngine.h"
+
+namespace
+{
+    using Vec = juce::dsp::SIMDRegister<float>;
+    constexpr int lanes = (int)Vec::size();
+}
+
+ModulationEngine::ModulationEngine(int numVoices)
+{
+    phase.assign((size_t)numVoices, 0.0);
+}
+
+void ModulationEngine::prepare(double sampleRate, int maxBlockSize)
+{
+    inverseSampleRate = 1.0 / sampleRate;
+    frequencies.setSize((int)phase.size(), maxBlockSize);
+
+    // Rounded up to whole registers, plus room to align the start
+    const int padded = (maxBlockSize + lanes - 1) / lanes * lanes;
+    shapeStorage.allocate((size_t)(padded + lanes), true);
+    shapeBuffer = Vec::getNextSIMDAlignedPtr(shapeStorage.get());
+
+    reset();
+}
+
+void ModulationEngine::reset()
+{
+    std::fill(phase.begin(), phase.end(), 0.0);
+    frequencies.clear();
+}
+
+void ModulationEngine::setParameters(const float* minFrequencyBlock, const float* maxFrequencyBlock, float rateHz, Shape newShape) noexcept
+{
+    minFrequency = minFrequencyBlock;
+    maxFrequency = maxFrequencyBlock;
+    rate = rateHz;
+    shape = newShape;
+}
+
+const float* ModulationEngine::process(int voiceIndex, int startSample, int numSamples) noexcept
+{
+    auto& voicePhase = phase[(size_t)voiceIndex];
+    const double increment = rate * inverseSampleRate;
+
+    renderShape((float)voicePhase, (float)increment, numSamples);
+
+    voicePhase += increment * numSamples;
+    voicePhase -= std::floor(voicePhase);
+
+    // frequency = min + (max - min) * (0.5 + 0.5 * lfo)
+    auto* dest = frequencies.getWritePointer(voiceIndex, startSample);
+
+    if (minFrequency == nullptr || maxFrequency == nullptr)
+    {
+        juce::FloatVectorOperations::fill(dest, 0.0f, numSamples);
+        return frequencies.getReadPointer(voiceIndex);
+    }
+
+    juce::FloatVectorOperations::multiply(shapeBuffer, 0.5f, numSamples);
+    juce::FloatVectorOperations::add(shapeBuffer, 0.5f, numSamples);
+    juce::FloatVectorOperations::subtract(dest, maxFrequency + startSample, minFrequency + startSample, numSamples);
+    juce::FloatVectorOperations::multiply(dest, shapeBuffer, numSamples);
+    juce::FloatVectorOperations::add(dest, minFrequency + startSample, numSamples);
+
+    return frequencies.getReadPointer(voiceIndex);
+}
+
+void ModulationEngine::renderShape(float startPhase, float increment, int numSamples) noexcept
+{
+    alignas(Vec::SIMDRegisterSize) float ramp[lanes];
+    for (int l = 0; l < lanes; ++l)
+        ramp[l] = startPhase + increment * (float)l;
+
+    const auto one = Vec::expand(1.0f);
+    const auto half = Vec::expand(0.5f);
+    const auto step = Vec::expand(increment * (float)lanes);
+    auto p = Vec::fromRawArray(ramp);
+
+    // The increment is far below one cycle per register, so one subtraction wraps
+    for (int i = 0; i < numSamples; i += lanes)
+    {
+        p -= one & Vec::greaterThanOrEqual(p, one);
+
+        Vec value;
+
+        switch (shape)
+        {
+            case Shape::sine:
+            {
+                // Parabolic sine with one refinement step, under 0.1% error: plenty for an LFO
+                const auto x = half - p;    // sin(2 pi p) = sin(2 pi (0.5 - p))
+                auto y = x * Vec::expand(8.0f) - x * Vec::abs(x) * Vec::expand(16.0f);
+                value = y + (y * Vec::abs(y) - y) * Vec::expand(0.225f);
+                break;
+            }
+
+            case Shape::triangle:
+                value = Vec::expand(4.0f) * Vec::abs(p - half) - one;
+                break;
+
+            case Shape::saw:
+                value = p * Vec::expand(2.0f) - one;
+                break;
+
+            case Shape::square:
+                value = (one & Vec::lessThan(p, half)) * Vec::expand(2.0f) - one;
+                break;
+        }
+
+        value.copyToRawArray(shapeBuffer + i);
+        p += step;
+    }
+}
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    ModulationEngine.h
+    Created: 17 Oct 2026 8:34:52pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Control-rate engine for the pitch sweep. Every voice has its own LFO phase, and
+// process() writes that voice's frequency for every sample of a (sub-)block into a
+// buffer allocated in prepare(), so the sweep is the same whatever the host's block
+// size or wherever the synth splits it. The LFO shapes are computed with
+// juce::dsp::SIMDRegister, a register's worth of samples at a time.
+class ModulationEngine
+{
+public:
+    enum class Shape
+    {
+        sine = 0,
+        triangle,
+        saw,
+        square
+    };
+
+    explicit ModulationEngine(int numVoices);
+
+    void prepare(double sampleRate, int maxBlockSize);
+    void reset();
+
+    // Per-block settings. minFrequency and maxFrequency hold one value per sample of
+    // the host block, they have to stay valid until the block has been rendered.
+    void setParameters(const float* minFrequency, const float* maxFrequency, float rateHz, Shape shape) noexcept;
+
+    // Frequency in Hz for samples [startSample, startSample + numSamples) of the block,
+    // advancing the voice's LFO. The result is indexed like the host buffer.
+    const float* process(int voiceIndex, int startSample, int numSamples) noexcept;
+
+private:
+    void renderShape(float startPhase, float increment, int numSamples) noexcept;
+
+    std::vector<double> phase;          // cycles, one per voice
+    double inverseSampleRate = 1.0 / 44100.0;
+
+    const float* minFrequency = nullptr;
+    const float* maxFrequency = nullptr;
+    float rate = 1.0f;
+    Shape shape = Shape::sine;
+
+    juce::AudioBuffer<float> frequencies;  // one channel per voice
+    juce::HeapBlock<float> shapeStorage;   // SIMD aligned scratch for one block of LFO values
+    float* shapeBuffer = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE(ModulationEngine)
+};
@@ -0,0 +1,213 @@
+/*
+  ==============================================================================
+
+    NoiseBank.cpp
+    Created: 18 Oct 2026 6:21:05am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "NoiseBank.h"
+
+namespace
+{
+    // Weyl sequence through the lowbias32 finaliser: every bit of the counter reaches
+    // every bit of the result, and consecutive counters come out uncorrelated
+    inline juce::uint32 hash(juce::uint32 x) noexcept
+    {
+        x ^= x >> 16;
+        x *= 0x7feb352du;
+        x ^= x >> 15;
+        x *= 0x846ca68bu;
+        x ^= x >> 16;
+        return x;
+    }
+
+    constexpr juce::uint32 weyl = 0x9e3779b9u;
+    constexpr float bandQ = 4.3f;           // a third of an octave
+    constexpr float maxBandGain = 32.0f;
+}
+
+NoiseBank::NoiseBank(int numVoices)
+{
+    keys.assign((size_t)numVoices, 0);
+    counters.assign((size_t)numVoices, 0);
+
+    for (auto& state : states)
+        state.assign((size_t)numVoices, 0.0f);
+
+    for (auto& coefficients : bandCoefficients)
+        coefficients.assign((size_t)numVoices, 0.0f);
+
+    setSeed(0);
+}
+
+void NoiseBank::prepare(double newSampleRate, int maxBlockSize)
+{
+    sampleRate = newSampleRate;
+    output.setSize((int)keys.size(), maxBlockSize);
+    output.clear();
+
+    std::fill(counters.begin(), counters.end(), 0u);
+
+    for (int v = 0; v < (int)keys.size(); ++v)
+    {
+        resetVoice(v);
+        setCentreFrequency(v, 1000.0f);
+    }
+}
+
+void NoiseBank::setSeed(juce::uint32 newSeed) noexcept
+{
+    seed = newSeed;
+
+    for (size_t v = 0; v < keys.size(); ++v)
+        keys[v] = hash(hash(seed) + (juce::uint32)v * weyl);
+}
+
+void NoiseBank::resetVoice(int voiceIndex) noexcept
+{
+    for (auto& state : states)
+        state[(size_t)voiceIndex] = 0.0f;
+}
+
+void NoiseBank::setCentreFrequency(int voiceIndex, float frequency) noexcept
+{
+    // Zavalishin's state variable filter, the band pass scaled to unity at the peak and
+    // then up by the power the band leaves out, so every pitch is about as loud
+    const float nyquist = 0.49f * (float)sampleRate;
+    frequency = juce::jlimit(10.0f, nyquist, frequency);
+
+    const float g = std::tan(juce::MathConstants<float>::pi * frequency / (float)sampleRate);
+    const float k = 1.0f / bandQ;
+    const float a1 = 1.0f / (1.0f + g * (g + k));
+    const auto v = (size_t)voiceIndex;
+
+    bandCoefficients[0][v] = a1;
+    bandCoefficients[1][v] = g * a1;
+    bandCoefficients[2][v] = g * g * a1;
+    bandCoefficients[3][v] = k * juce::jmin(maxBandGain, std::sqrt((float)sampleRate * bandQ / (juce::MathConstants<float>::pi * frequency)));
+}
+
+void NoiseBank::renderWhite(float* dest, juce::uint32 key, juce::uint32 counter, int numSamples) noexcept
+{
+    constexpr float scale = 1.0f / 2147483648.0f;
+
+    // Integer hash to signed float, nothing carried between iterations
+    for (int i = 0; i < numSamples; ++i)
+        dest[i] = (float)(juce::int32)hash((counter + (juce::uint32)i) * weyl + key) * scale;
+}
+
+void NoiseBank::render(const int* voiceIndices, int numVoicesToRender, int startSample, int numSamples) noexcept
+{
+    for (int n = 0; n < numVoicesToRender; ++n)
+    {
+        const auto v = (size_t)voiceIndices[n];
+        renderWhite(output.getWritePointer((int)v, startSample), keys[v], counters[v], numSamples);
+        counters[v] += (juce::uint32)numSamples;
+    }
+
+    constexpr int lanes = (int)juce::dsp::SIMDRegister<float>::size();
+
+    // The colour is picked once per group, the sample loops don't branch
+    for (int first = 0; first < numVoicesToRender; first += lanes)
+    {
+        const int count = juce::jmin(lanes, numVoicesToRender - first);
+
+        switch (colour)
+        {
+            case Colour::pink:  renderColour<Colour::pink>(voiceIndices + first, count, startSample, numSamples); break;
+            case Colour::brown: renderColour<Colour::brown>(voiceIndices + first, count, startSample, numSamples); break;
+            case Colour::band:  renderColour<Colour::band>(voiceIndices + first, count, startSample, numSamples); break;
+            case Colour::off:
+            case Colour::white: return;
+        }
+    }
+}
+
+template <NoiseBank::Colour shape>
+void NoiseBank::renderColour(const int* voices, int count, int startSample, int numSamples) noexcept
+{
+    using Vec = juce::dsp::SIMDRegister<float>;
+    constexpr int lanes = (int)Vec::size();
+
+    alignas(Vec::SIMDRegisterSize) float lanesIn[lanes];
+    alignas(Vec::SIMDRegisterSize) float lanesOut[lanes];
+    alignas(Vec::SIMDRegisterSize) float gather[numStates + 4][lanes];
+    float* destLanes[lanes];
+
+    // Gather the group into lanes, spare lanes duplicate a real voice and are dropped
+    for (int l = 0; l < lanes; ++l)
+    {
+        const auto v = (size_t)voices[juce::jmin(l, count - 1)];
+        destLanes[l] = output.getWritePointer((int)v, startSample);
+
+        for (int s = 0; s < numStates; ++s)
+            gather[s][l] = states[(size_t)s][v];
+
+        for (int c = 0; c < 4; ++c)
+            gather[numStates + c][l] = bandCoefficients[(size_t)c][v];
+    }
+
+    Vec state[numStates];
+    for (int s = 0; s < numStates; ++s)
+        state[s] = Vec::fromRawArray(gather[s]);
+
+    const auto a1 = Vec::fromRawArray(gather[numStates]);
+    const auto a2 = Vec::fromRawArray(gather[numStates + 1]);
+    const auto a3 = Vec::fromRawArray(gather[numStates + 2]);
+    const auto bandGain = Vec::fromRawArray(gather[numStates + 3]);
+    const auto two = Vec::expand(2.0f);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        for (int l = 0; l < lanes; ++l)
+            lanesIn[l] = destLanes[l][i];
+
+        const auto white = Vec::fromRawArray(lanesIn);
+        Vec result;
+
+        if constexpr (shape == Colour::pink)
+        {
+            // Paul Kellet's refined filter, within 0.05 dB of -3 dB/octave above 9 Hz at 44.1 kHz
+            state[0] = state[0] * Vec::expand(0.99886f) + white * Vec::expand(0.0555179f);
+            state[1] = state[1] * Vec::expand(0.99332f) + white * Vec::expand(0.0750759f);
+            state[2] = state[2] * Vec::expand(0.96900f) + white * Vec::expand(0.1538520f);
+            state[3] = state[3] * Vec::expand(0.86650f) + white * Vec::expand(0.3104856f);
+            state[4] = state[4] * Vec::expand(0.55000f) + white * Vec::expand(0.5329522f);
+            state[5] = state[5] * Vec::expand(-0.7616f) - white * Vec::expand(0.0168980f);
+            result = (state[0] + state[1] + state[2] + state[3] + state[4] + state[5] + state[6]
+                      + white * Vec::expand(0.5362f)) * Vec::expand(0.2f);
+            state[6] = white * Vec::expand(0.115926f);
+        }
+        else if constexpr (shape == Colour::brown)
+        {
+            // Leaky integrator, the leak keeps it from wandering off
+            state[7] = state[7] * Vec::expand(1.0f / 1.02f) + white * Vec::expand(0.02f / 1.02f);
+            result = state[7] * Vec::expand(6.0f);
+        }
+        else
+        {
+            const auto v3 = white - state[9];
+            const auto v1 = a1 * state[8] + a2 * v3;
+            const auto v2 = state[9] + a2 * state[8] + a3 * v3;
+            state[8] = two * v1 - state[8];
+            state[9] = two * v2 - state[9];
+            result = v1 * bandGain;
+        }
+
+        result.copyToRawArray(lanesOut);
+
+        for (int l = 0; l < count; ++l)
+            destLanes[l][i] = lanesOut[l];
+    }
+
+    for (int s = 0; s < numStates; ++s)
+    {
+        state[s].copyToRawArray(gather[s]);
+
+        for (int l = 0; l < count; ++l)
+            states[(size_t)s][(size_t)voices[l]] = gather[s][l];
+    }
+}
@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    NoiseBank.h
+    Created: 18 Oct 2026 6:21:05am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Noise sources for every voice in the pool, in place of the oscillators: for masking
+// and localisation tests, placed and moved like any other voice.
+//
+// Every sample is a hash of the voice's key and its own sample counter, a counter-based
+// generator, so there's no state to carry from one sample to the next: the white noise
+// loop has no branches and no dependencies and the compiler vectorises it across the
+// block. The same seed and the same notes always give the same noise, whatever the
+// block sizes or threads. Colours are filters over the white noise, run a SIMD register
+// of voices at a time like WavetableOscillatorBank.
+class NoiseBank
+{
+public:
+    enum class Colour
+    {
+        off = 0,    // the voices play their oscillators
+        white,
+        pink,       // -3 dB per octave
+        brown,      // -6 dB per octave
+        band        // a third of an octave around the voice's pitch
+    };
+
+    explicit NoiseBank(int numVoices);
+
+    // Starts every voice's counter from 0
+    void prepare(double sampleRate, int maxBlockSize);
+
+    void setColour(Colour newColour) noexcept { colour = newColour; }
+    Colour getColour() const noexcept { return colour; }
+    bool isEnabled() const noexcept { return colour != Colour::off; }
+
+    // Voices get different noise from the same seed, and the same noise every time from it
+    void setSeed(juce::uint32 newSeed) noexcept;
+    juce::uint32 getSeed() const noexcept { return seed; }
+
+    // Clears the voice's filters, its counter carries on so no two notes sound the same
+    void resetVoice(int voiceIndex) noexcept;
+
+    // Middle of the band for the "band" colour, in Hz
+    void setCentreFrequency(int voiceIndex, float frequency) noexcept;
+
+    // Renders samples [startSample, startSample + numSamples) of the given voices
+    void render(const int* voiceIndices, int numVoicesToRender, int startSample, int numSamples) noexcept;
+
+    // The block rendered for one voice, indexed like the host buffer
+    const float* getOutput(int voiceIndex) const noexcept { return output.getReadPointer(voiceIndex); }
+
+private:
+    // Pink noise filter state, then brown, then the band pass's two integrators
+    static constexpr int numStates = 10;
+
+    // Fills dest with uniform noise in -1..1 for numSamples from counter
+    static void renderWhite(float* dest, juce::uint32 key, juce::uint32 counter, int numSamples) noexcept;
+
+    // Filters the white noise of up to a register of voices
+    template <Colour shape>
+    void renderColour(const int* voices, int count, int startSample, int numSamples) noexcept;
+
+    Colour colour = Colour::off;
+    juce::uint32 seed = 0;
+    double sampleRate = 44100.0;
+
+    std::vector<juce::uint32> keys;         // per voice, from the seed
+    std::vector<juce::uint32> counters;     // samples rendered, per voice
+
+    // Per voice: filter state, and the band pass's coefficients and gain
+    std::array<std::vector<float>, numStates> states;
+    std::array<std::vector<float>, 4> bandCoefficients;
+
+    juce::AudioBuffer<float> output;        // one channel per voice
+
+    JUCE_DECLARE_NON_COPYABLE(NoiseBank)
+};
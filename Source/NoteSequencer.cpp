@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    NoteSequencer.cpp
+    Created: 17 Oct 2026 1:41:22pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "NoteSequencer.h"
+
+void NoteSequencer::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    reset();
+}
+
+void NoteSequencer::reset()
+{
+    sampleClock = 0;
+    freeRunPosition = 0.0;
+    lastTriggeredStep = std::numeric_limits<juce::int64>::min();
+    pendingStart = 0;
+    pendingCount = 0;
+}
+
+void NoteSequencer::setNumSteps(int newNumSteps) noexcept
+{
+    numSteps = juce::jlimit(1, maxSteps, newNumSteps);
+}
+
+void NoteSequencer::process(juce::AudioPlayHead* playHead, int numSamples, juce::MidiBuffer& midi) noexcept
+{
+    const auto blockStart = sampleClock;
+
+    double stepPosition = freeRunPosition;
+    double stepsPerSample = 1.0 / (freeRunStepSeconds * sampleRate);
+    bool synced = false;
+
+    // Follow the host's grid while it plays, free-run otherwise
+    if (playHead != nullptr)
+    {
+        if (const auto position = playHead->getPosition())
+        {
+            const auto bpm = position->getBpm();
+            const auto ppq = position->getPpqPosition();
+
+            if (position->getIsPlaying() && bpm.hasValue() && ppq.hasValue() && *bpm > 0.0)
+            {
+                stepPosition = *ppq * stepsPerBeat;
+                stepsPerSample = *bpm / 60.0 * stepsPerBeat / sampleRate;
+                synced = true;
+            }
+        }
+    }
+
+    // A step boundary belongs to the first sample at or after it. Starting one sample
+    // back catches a boundary that fell just after the previous block's last sample.
+    const double samplesPerStep = 1.0 / stepsPerSample;
+    auto nextStep = (juce::int64)std::floor(stepPosition - stepsPerSample) + 1;
+
+    for (;; ++nextStep)
+    {
+        // (the epsilon keeps accumulated rounding from pushing a boundary one sample late)
+        const auto offset = juce::jmax(0, (int)std::ceil((double)(nextStep - stepPosition) * samplesPerStep - 1.0e-6));
+
+        if (offset >= numSamples)
+            break;
+
+        // Host positions are rounded, don't let one boundary fire in two blocks
+        if (nextStep == lastTriggeredStep)
+            continue;
+
+        // Offs due by now go first so a retriggered note is released before it restarts
+        flushNoteOffs(blockStart + offset, blockStart, midi);
+
+        const auto stepIndex = (int)((nextStep % numSteps + numSteps) % numSteps);
+        triggerStep(stepIndex, blockStart + offset, samplesPerStep, blockStart, midi);
+        lastTriggeredStep = nextStep;
+    }
+
+    flushNoteOffs(blockStart + numSamples - 1, blockStart, midi);
+
+    if (!synced)
+        freeRunPosition = stepPosition + numSamples * stepsPerSample;
+
+    sampleClock += numSamples;
+}
+
+void NoteSequencer::triggerStep(int stepIndex, juce::int64 time, double samplesPerStep,
+                                juce::int64 blockStart, juce::MidiBuffer& midi) noexcept
+{
+    const auto& step = steps[(size_t)stepIndex];
+
+    // A note that can't be released is worse than a missing one
+    if (!step.active || pendingCount == maxPendingEvents)
+        return;
+
+    midi.addEvent(juce::MidiMessage::noteOn(midiChannel, step.noteNumber, step.velocity), (int)(time - blockStart));
+
+    const auto gate = juce::jmax((juce::int64)1, (juce::int64)std::llround(step.gateSteps * samplesPerStep));
+    pending[(size_t)((pendingStart + pendingCount) % maxPendingEvents)] = { time + gate, step.noteNumber };
+    ++pendingCount;
+}
+
+void NoteSequencer::flushNoteOffs(juce::int64 upToTime, juce::int64 blockStart, juce::MidiBuffer& midi) noexcept
+{
+    // Walk the ring once: due events are sent, the rest go back on the end
+    for (int remaining = pendingCount; remaining > 0; --remaining)
+    {
+        const auto event = pending[(size_t)pendingStart];
+        pendingStart = (pendingStart + 1) % maxPendingEvents;
+        --pendingCount;
+
+        if (event.time <= upToTime)
+        {
+            const auto offset = (int)juce::jmax((juce::int64)0, event.time - blockStart);
+            midi.addEvent(juce::MidiMessage::noteOff(midiChannel, event.noteNumber, 0.0f), offset);
+        }
+        else
+        {
+            pending[(size_t)((pendingStart + pendingCount) % maxPendingEvents)] = event;
+            ++pendingCount;
+        }
+    }
+}
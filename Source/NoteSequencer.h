@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    NoteSequencer.h
+    Created: 17 Oct 2026 1:41:22pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Step sequencer driven by the sample clock. When the host is playing and reports
+// a tempo, steps are locked to its PPQ position, otherwise they free-run at a fixed
+// step length. Notes are written into a MidiBuffer at exact sample offsets, so
+// offline renders are deterministic and never wait on the wall clock.
+//
+// All the storage (steps and pending note-offs) is fixed size, nothing allocates
+// after construction.
+class NoteSequencer
+{
+public:
+    static constexpr int maxSteps = 64;
+    static constexpr int maxPendingEvents = 256;
+
+    struct Step
+    {
+        bool active = false;
+        int noteNumber = 60;
+        float velocity = 0.8f;
+        int gateSteps = 1;      // how many steps the note is held for
+    };
+
+    NoteSequencer() = default;
+
+    void prepare(double sampleRate);
+    void reset();
+
+    void setNumSteps(int newNumSteps) noexcept;
+    int getNumSteps() const noexcept { return numSteps; }
+    Step& getStep(int index) noexcept { return steps[(size_t)index]; }
+
+    void setMidiChannel(int channel) noexcept { midiChannel = channel; }
+    void setStepsPerBeat(int newStepsPerBeat) noexcept { stepsPerBeat = juce::jmax(1, newStepsPerBeat); }
+    void setFreeRunningStepLength(double seconds) noexcept { freeRunStepSeconds = juce::jmax(0.001, seconds); }
+
+    // Adds this block's note events to midi, with offsets in [0, numSamples)
+    void process(juce::AudioPlayHead* playHead, int numSamples, juce::MidiBuffer& midi) noexcept;
+
+private:
+    struct PendingNoteOff
+    {
+        juce::int64 time;   // on the sequencer's sample clock
+        int noteNumber;
+    };
+
+    void triggerStep(int stepIndex, juce::int64 time, double samplesPerStep, juce::int64 blockStart, juce::MidiBuffer& midi) noexcept;
+    void flushNoteOffs(juce::int64 upToTime, juce::int64 blockStart, juce::MidiBuffer& midi) noexcept;
+
+    std::array<Step, maxSteps> steps;
+    int numSteps = 16;
+    int midiChannel = 1;
+    int stepsPerBeat = 4;
+    double freeRunStepSeconds = 0.1;
+
+    // Note-offs waiting for their time, as a fixed ring
+    std::array<PendingNoteOff, maxPendingEvents> pending;
+    int pendingStart = 0;
+    int pendingCount = 0;
+
+    double sampleRate = 44100.0;
+    juce::int64 sampleClock = 0;        // samples processed since prepare()
+    double freeRunPosition = 0.0;       // in steps
+    juce::int64 lastTriggeredStep = std::numeric_limits<juce::int64>::min();
+};
@@ -0,0 +1,329 @@
+/*
+  ==============================================================================
+
+    PartitionedConvolver.cpp
+    Created: 17 Oct 2026 3:05:51pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "PartitionedConvolver.h"
+
+namespace
+{
+    // acc += a * b for interleaved complex bins
+    inline void multiplyAccumulate(float* acc, const float* a, const float* b, int numBins) noexcept
+    {
+        for (int i = 0; i < numBins; ++i)
+        {
+            const float re = a[2 * i] * b[2 * i] - a[2 * i + 1] * b[2 * i + 1];
+            const float im = a[2 * i] * b[2 * i + 1] + a[2 * i + 1] * b[2 * i];
+            acc[2 * i] += re;
+            acc[2 * i + 1] += im;
+        }
+    }
+
+    int getOrder(int size) noexcept
+    {
+        int order = 0;
+        while ((1 << order) < size)
+            ++order;
+        return order;
+    }
+}
+
+//==============================================================================
+void UniformConvolver::prepare(int partitionSize, int maxNumPartitions, int numChannels)
+{
+    jassert(juce::isPowerOfTwo(partitionSize));
+
+    blockSize = partitionSize;
+    fftSize = 2 * partitionSize;
+    spectrumSize = getSpectrumSize(partitionSize);
+    maxPartitions = juce::jmax(1, maxNumPartitions);
+
+    fft = std::make_unique<juce::dsp::FFT>(getOrder(fftSize));
+
+    // juce::dsp::FFT's real transforms work in place on 2 * fftSize floats
+    work.allocate((size_t)(2 * fftSize), true);
+    previousOutput.allocate((size_t)blockSize, true);
+
+    channels.clear();
+    channels.resize((size_t)numChannels);
+
+    for (auto& channel : channels)
+    {
+        channel.history.allocate((size_t)fftSize, true);
+        channel.fdl.allocate((size_t)(maxPartitions * spectrumSize), true);
+    }
+
+    reset();
+}
+
+void UniformConvolver::reset()
+{
+    for (auto& channel : channels)
+    {
+        std::fill(channel.history.get(), channel.history.get() + fftSize, 0.0f);
+        std::fill(channel.fdl.get(), channel.fdl.get() + maxPartitions * spectrumSize, 0.0f);
+        channel.fdlPosition = 0;
+
+        if (channel.hasPending)
+        {
+            channel.filter = channel.pendingFilter;
+            channel.filterPartitions = channel.pendingPartitions;
+            channel.hasPending = false;
+        }
+    }
+}
+
+void UniformConvolver::computeSpectra(const float* impulse, int length, int partitionSize, float* dest)
+{
+    const int size = 2 * partitionSize;
+    const int floatsPerSpectrum = getSpectrumSize(partitionSize);
+    juce::dsp::FFT transform(getOrder(size));
+    std::vector<float> buffer((size_t)(2 * size));
+
+    for (int start = 0, p = 0; start < length; start += partitionSize, ++p)
+    {
+        // Overlap-save: the partition goes in the first half, the rest is zeros
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        std::copy(impulse + start, impulse + juce::jmin(length, start + partitionSize), buffer.begin());
+
+        transform.performRealOnlyForwardTransform(buffer.data(), true);
+        std::copy(buffer.begin(), buffer.begin() + floatsPerSpectrum, dest + p * floatsPerSpectrum);
+    }
+}
+
+void UniformConvolver::setFilter(int channelIndex, const float* spectra, int numPartitions) noexcept
+{
+    auto& channel = channels[(size_t)channelIndex];
+    numPartitions = juce::jmin(numPartitions, maxPartitions);
+
+    if (spectra == channel.filter && numPartitions == channel.filterPartitions)
+    {
+        channel.hasPending = false;
+        return;
+    }
+
+    channel.pendingFilter = spectra;
+    channel.pendingPartitions = numPartitions;
+    channel.hasPending = true;
+}
+
+void UniformConvolver::convolve(const Channel& channel, const float* filter, int numPartitions, float* dest) noexcept
+{
+    auto* acc = work.get();
+    std::fill(acc, acc + 2 * fftSize, 0.0f);
+
+    if (filter != nullptr)
+    {
+        // Partition p of the filter meets the input spectrum from p partitions ago
+        for (int p = 0; p < numPartitions; ++p)
+        {
+            const int slot = (channel.fdlPosition - p + maxPartitions) % maxPartitions;
+            multiplyAccumulate(acc, channel.fdl.get() + slot * spectrumSize, filter + p * spectrumSize, blockSize + 1);
+        }
+    }
+
+    fft->performRealOnlyInverseTransform(acc);
+
+    // Only the second half is free of circular wrap-around
+    std::copy(acc + blockSize, acc + fftSize, dest);
+}
+
+void UniformConvolver::process(const float* const* input, float* const* output) noexcept
+{
+    for (size_t c = 0; c < channels.size(); ++c)
+    {
+        auto& channel = channels[c];
+
+        // Slide the input window and add its spectrum to the delay line
+        std::copy(channel.history.get() + blockSize, channel.history.get() + fftSize, channel.history.get());
+        std::copy(input[c], input[c] + blockSize, channel.history.get() + blockSize);
+
+        channel.fdlPosition = (channel.fdlPosition + 1) % maxPartitions;
+
+        auto* spectrum = work.get();
+        std::copy(channel.history.get(), channel.history.get() + fftSize, spectrum);
+        std::fill(spectrum + fftSize, spectrum + 2 * fftSize, 0.0f);
+        fft->performRealOnlyForwardTransform(spectrum, true);
+        std::copy(spectrum, spectrum + spectrumSize, channel.fdl.get() + channel.fdlPosition * spectrumSize);
+
+        if (!channel.hasPending)
+        {
+            convolve(channel, channel.filter, channel.filterPartitions, output[c]);
+            continue;
+        }
+
+        // Filter swap: run both and crossfade across this partition
+        convolve(channel, channel.filter, channel.filterPartitions, previousOutput.get());
+        convolve(channel, channel.pendingFilter, channel.pendingPartitions, output[c]);
+
+        const float step = 1.0f / (float)blockSize;
+
+        for (int i = 0; i < blockSize; ++i)
+        {
+            const float fade = (float)(i + 1) * step;
+            output[c][i] = previousOutput[i] + fade * (output[c][i] - previousOutput[i]);
+        }
+
+        channel.filter = channel.pendingFilter;
+        channel.filterPartitions = channel.pendingPartitions;
+        channel.hasPending = false;
+    }
+}
+
+//==============================================================================
+void PartitionedConvolver::prepare(int headPartitionSize, int numHeadPartitions, int maxTailPartitions, int channelsToUse)
+{
+    blockSize = headPartitionSize;
+    tailSize = headPartitionSize * numHeadPartitions;
+    numChannels = channelsToUse;
+    hasTail = maxTailPartitions > 0;
+
+    head.prepare(blockSize, numHeadPartitions, numChannels);
+
+    // The tail's first tap sits exactly one tail partition in, which is what lets it
+    // finish a whole partition before any of its output is due
+    if (hasTail)
+    {
+        tail.prepare(tailSize, maxTailPartitions, numChannels);
+        tailInput.setSize(numChannels, tailSize);
+        tailOutput.setSize(numChannels, tailSize);
+    }
+
+    inputFifo.setSize(numChannels, blockSize);
+    outputFifo.setSize(numChannels, blockSize);
+
+    inputPointers.resize((size_t)numChannels);
+    outputPointers.resize((size_t)numChannels);
+
+    reset();
+}
+
+void PartitionedConvolver::reset()
+{
+    head.reset();
+    inputFifo.clear();
+    outputFifo.clear();
+    fifoPosition = 0;
+
+    if (hasTail)
+    {
+        tail.reset();
+        tailInput.clear();
+        tailOutput.clear();
+    }
+
+    tailPosition = 0;
+}
+
+void PartitionedConvolver::setFilter(int channel, const ConvolutionFilter& filter) noexcept
+{
+    head.setFilter(channel, filter.headSpectra, filter.numHeadPartitions);
+
+    if (hasTail)
+        tail.setFilter(channel, filter.tailSpectra, filter.numTailPartitions);
+}
+
+bool PartitionedConvolver::isReading(int channel, const float* begin, const float* end) const noexcept
+{
+    auto inRange = [begin, end](const float* p) { return p != nullptr && p >= begin && p < end; };
+    return inRange(head.getCurrentFilter(channel)) || (hasTail && inRange(tail.getCurrentFilter(channel)));
+}
+
+void PartitionedConvolver::process(const float* const* input, float* const* output, int numSamples) noexcept
+{
+    for (int done = 0; done < numSamples;)
+    {
+        const int chunk = juce::jmin(numSamples - done, blockSize - fifoPosition);
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            // Read before writing, output may alias input
+            juce::FloatVectorOperations::copy(inputFifo.getWritePointer(c, fifoPosition), input[c] + done, chunk);
+            juce::FloatVectorOperations::copy(output[c] + done, outputFifo.getReadPointer(c, fifoPosition), chunk);
+        }
+
+        fifoPosition += chunk;
+        done += chunk;
+
+        if (fifoPosition == blockSize)
+        {
+            processPartition();
+            fifoPosition = 0;
+        }
+    }
+}
+
+void PartitionedConvolver::processPartition() noexcept
+{
+    for (int c = 0; c < numChannels; ++c)
+    {
+        inputPointers[(size_t)c] = inputFifo.getReadPointer(c);
+        outputPointers[(size_t)c] = outputFifo.getWritePointer(c);
+    }
+
+    head.process(inputPointers.data(), outputPointers.data());
+
+    if (!hasTail)
+        return;
+
+    const int offset = tailPosition * blockSize;
+
+    for (int c = 0; c < numChannels; ++c)
+    {
+        // This slice of the tail was computed from the previous tail window
+        juce::FloatVectorOperations::add(outputFifo.getWritePointer(c), tailOutput.getReadPointer(c, offset), blockSize);
+        juce::FloatVectorOperations::copy(tailInput.getWritePointer(c, offset), inputFifo.getReadPointer(c), blockSize);
+    }
+
+    if (++tailPosition * blockSize == tailSize)
+    {
+        for (int c = 0; c < numChannels; ++c)
+        {
+            inputPointers[(size_t)c] = tailInput.getReadPointer(c);
+            outputPointers[(size_t)c] = tailOutput.getWritePointer(c);
+        }
+
+        tail.process(inputPointers.data(), outputPointers.data());
+        tailPosition = 0;
+    }
+}
+
+//==============================================================================
+void ConvolutionFilterData::build(const float* impulse, int length, int headPartitionSize, int maxHeadPartitions)
+{
+    const int headLength = juce::jmin(length, headPartitionSize * maxHeadPartitions);
+    const int tailPartitionSize = headPartitionSize * maxHeadPartitions;
+
+    numHeadPartitions = (headLength + headPartitionSize - 1) / headPartitionSize;
+    headSpectra.allocate((size_t)(numHeadPartitions * UniformConvolver::getSpectrumSize(headPartitionSize)), true);
+    UniformConvolver::computeSpectra(impulse, headLength, headPartitionSize, headSpectra.get());
+
+    const int tailLength = length - headLength;
+    numTailPartitions = (tailLength + tailPartitionSize - 1) / tailPartitionSize;
+
+    if (numTailPartitions > 0)
+    {
+        tailSpectra.allocate((size_t)(numTailPartitions * UniformConvolver::getSpectrumSize(tailPartitionSize)), true);
+        UniformConvolver::computeSpectra(impulse + headLength, tailLength, tailPartitionSize, tailSpectra.get());
+    }
+    else
+    {
+        tailSpectra.free();
+    }
+}
+
+void ConvolutionFilterData::buildIdentity(int headPartitionSize)
+{
+    const float impulse = 1.0f;
+    build(&impulse, 1, headPartitionSize, 1);
+}
+
+ConvolutionFilter ConvolutionFilterData::getFilter() const noexcept
+{
+    return { headSpectra.get(), numHeadPartitions, tailSpectra.get(), numTailPartitions };
+}
@@ -0,0 +1,141 @@
+/*
+  ==============================================================================
+
+    PartitionedConvolver.h
+    Created: 17 Oct 2026 3:05:51pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Spectra of one impulse response, split for PartitionedConvolver: a head of small
+// partitions (low latency) and, for long responses, a tail of big partitions.
+// The spectra aren't owned, whoever supplies them keeps them alive while in use.
+struct ConvolutionFilter
+{
+    const float* headSpectra = nullptr;
+    int numHeadPartitions = 0;
+    const float* tailSpectra = nullptr;
+    int numTailPartitions = 0;
+
+    bool operator==(const ConvolutionFilter& other) const noexcept
+    {
+        return headSpectra == other.headSpectra && tailSpectra == other.tailSpectra
+            && numHeadPartitions == other.numHeadPartitions && numTailPartitions == other.numTailPartitions;
+    }
+
+    bool operator!=(const ConvolutionFilter& other) const noexcept { return !operator==(other); }
+};
+
+//==============================================================================
+// Uniformly partitioned overlap-save convolution, one partition at a time. Each
+// channel keeps a frequency-domain delay line of its past input spectra, so a new
+// filter can be swapped in at any partition: for that one partition the output is
+// computed with both filters and crossfaded.
+class UniformConvolver
+{
+public:
+    void prepare(int partitionSize, int maxPartitions, int numChannels);
+    void reset();
+
+    int getPartitionSize() const noexcept { return blockSize; }
+
+    // Floats per partition spectrum: partitionSize + 1 interleaved complex bins
+    static int getSpectrumSize(int partitionSize) noexcept { return 2 * (partitionSize + 1); }
+
+    // Fills dest with the spectra of ceil(length / partitionSize) partitions of impulse.
+    // Allocates, so only call it off the audio thread.
+    static void computeSpectra(const float* impulse, int length, int partitionSize, float* dest);
+
+    // nullptr silences the channel. A change is crossfaded over the next partition.
+    void setFilter(int channel, const float* spectra, int numPartitions) noexcept;
+
+    // The filter a channel is currently convolving with, not counting a pending one
+    const float* getCurrentFilter(int channel) const noexcept { return channels[(size_t)channel].filter; }
+
+    // Consumes partitionSize samples per channel and writes as many
+    void process(const float* const* input, float* const* output) noexcept;
+
+private:
+    struct Channel
+    {
+        juce::HeapBlock<float> history;     // last two partitions of input
+        juce::HeapBlock<float> fdl;         // maxPartitions input spectra, as a ring
+        int fdlPosition = 0;
+
+        const float* filter = nullptr;
+        int filterPartitions = 0;
+        const float* pendingFilter = nullptr;
+        int pendingPartitions = 0;
+        bool hasPending = false;
+    };
+
+    void convolve(const Channel& channel, const float* filter, int numPartitions, float* dest) noexcept;
+
+    std::unique_ptr<juce::dsp::FFT> fft;
+    int blockSize = 0, fftSize = 0, spectrumSize = 0, maxPartitions = 0;
+
+    juce::HeapBlock<float> work, previousOutput;
+    std::vector<Channel> channels;
+};
+
+//==============================================================================
+// Streams any block size through a UniformConvolver head and, for long filters, a
+// second UniformConvolver tail with partitions as long as the whole head. The tail
+// only runs once per tail partition, so long responses cost a fraction of what a
+// uniform partitioning would. Adds getLatency() samples of delay.
+class PartitionedConvolver
+{
+public:
+    void prepare(int headPartitionSize, int numHeadPartitions, int maxTailPartitions, int numChannels);
+    void reset();
+
+    int getLatency() const noexcept { return blockSize; }
+    int getTailPartitionSize() const noexcept { return tailSize; }
+
+    void setFilter(int channel, const ConvolutionFilter& filter) noexcept;
+
+    // Whether the filter in use (head or tail, not a pending one) lives in [begin, end).
+    // Memory that isn't in use can be rewritten and passed to setFilter() again.
+    bool isReading(int channel, const float* begin, const float* end) const noexcept;
+
+    // Replacing: output may be the same memory as input
+    void process(const float* const* input, float* const* output, int numSamples) noexcept;
+
+private:
+    void processPartition() noexcept;
+
+    UniformConvolver head, tail;
+    int blockSize = 0, tailSize = 0, numChannels = 0;
+    bool hasTail = false;
+
+    juce::AudioBuffer<float> inputFifo, outputFifo;
+    juce::AudioBuffer<float> tailInput, tailOutput;
+    int fifoPosition = 0;
+    int tailPosition = 0;    // partitions of the current tail window seen so far
+
+    std::vector<const float*> inputPointers;
+    std::vector<float*> outputPointers;
+};
+
+//==============================================================================
+// Owns the spectra of one impulse response, laid out for a PartitionedConvolver
+class ConvolutionFilterData
+{
+public:
+    // Allocates, so only call it off the audio thread
+    void build(const float* impulse, int length, int headPartitionSize, int numHeadPartitions);
+
+    // A single partition with every bin at 1, i.e. the filter that changes nothing
+    void buildIdentity(int headPartitionSize);
+
+    ConvolutionFilter getFilter() const noexcept;
+
+private:
+    juce::HeapBlock<float> headSpectra, tailSpectra;
+    int numHeadPartitions = 0, numTailPartitions = 0;
+};
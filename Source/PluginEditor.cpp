@@ -103,13 +103,59 @@ TapSynthAudioProcessorEditor::TapSynthAudioProcessorEditor(TapSynthAudioProcesso
     dimensionAttachment.reset(new juce::AudioProcessorValueTreeState::SliderAttachment(
         audioProcessor.getState(), "dimension", dimensionSlider));
 
-    setSize (width, heigth);
+    // Every change on the pad goes to the audio thread as one whole scene
+    sceneVersion = audioProcessor.getSceneVersion();
+    scenePad.setScene(audioProcessor.getScene());
+    scenePad.onSceneChanged = [this](const SceneSnapshot& scene) { audioProcessor.publishScene(scene); };
+    addAndMakeVisible(scenePad);
+
+    scenePadLabel.setText("Scene (shift-drag moves all, double-click adds/removes)", juce::dontSendNotification);
+    scenePadLabel.attachToComponent(&scenePad, false);
+    scenePadLabel.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(scenePadLabel);
+
+    // The "Spline" trajectory goes through the pad's sources, as seen from the middle of the box
+    splineFromSceneButton.setButtonText("Use scene as spline path");
+    splineFromSceneButton.onClick = [this]
+    {
+        const auto& scene = scenePad.getScene();
+        std::array<juce::Point<float>, SceneSnapshot::maxSources> points;
+
+        for (int s = 0; s < scene.numSources; ++s)
+            points[(size_t)s] = { (scene.positions[(size_t)s].x - 50.0f) / 50.0f, (scene.positions[(size_t)s].y - 50.0f) / 50.0f };
+
+        audioProcessor.setTrajectoryPoints(points.data(), scene.numSources);
+    };
+    addAndMakeVisible(splineFromSceneButton);
+
+    if (DspProfiler::isEnabled())
+    {
+        profileLabel.setFont(juce::Font(juce::FontOptions(11.0f)));
+        profileLabel.setJustificationType(juce::Justification::topLeft);
+        addAndMakeVisible(profileLabel);
+    }
+
+    setSize (width + padSize, heigth);
+    startTimerHz(10);
 }
 
 TapSynthAudioProcessorEditor::~TapSynthAudioProcessorEditor()
 {
 }
 
+void TapSynthAudioProcessorEditor::timerCallback()
+{
+    if (profileLabel.isVisible())
+        profileLabel.setText(audioProcessor.getProfiler().getSnapshot().toText(), juce::dontSendNotification);
+
+    const auto version = audioProcessor.getSceneVersion();
+    if (version == sceneVersion)
+        return;
+
+    sceneVersion = version;
+    scenePad.setScene(audioProcessor.getScene());
+}
+
 //==============================================================================
 void TapSynthAudioProcessorEditor::paint (juce::Graphics& g)
 {
@@ -119,9 +165,16 @@ void TapSynthAudioProcessorEditor::paint (juce::Graphics& g)
 void TapSynthAudioProcessorEditor::resized()
 {
     const int xMargin = 20, yMargin = 60;
-    const int sliderWidth = getWidth() / 4;
+    const int controlsWidth = getWidth() - padSize;
+    const int sliderWidth = controlsWidth / 4;
     const int sliderHeight = getHeight() / 4; 
 
+    // The pad sits to the right of the sliders
+    scenePad.setBounds(controlsWidth, yMargin, padSize - xMargin, padSize - xMargin);
+    splineFromSceneButton.setBounds(controlsWidth, yMargin + padSize - xMargin / 2, padSize - xMargin, 24);
+    profileLabel.setBounds(controlsWidth, yMargin + padSize - xMargin / 2 + 28, padSize - xMargin,
+                           getHeight() - (yMargin + padSize - xMargin / 2 + 28));
+
     // First row
     minFreqSlider.setBounds(
         xMargin, 
@@ -130,13 +183,13 @@ void TapSynthAudioProcessorEditor::resized()
         sliderHeight);
 
     lfoSpeedSlider.setBounds(
-        getWidth() / 2 - sliderWidth / 2, 
+        controlsWidth / 2 - sliderWidth / 2, 
         yMargin,
         sliderWidth, 
         sliderHeight);
 
     maxFreqSlider.setBounds(
-        getWidth() - sliderWidth - xMargin, 
+        controlsWidth - sliderWidth - xMargin, 
         yMargin,
         sliderWidth, 
         sliderHeight);
@@ -148,12 +201,12 @@ void TapSynthAudioProcessorEditor::resized()
         sliderWidth, 
         sliderHeight);
     ySlider.setBounds(
-        getWidth() / 2 - sliderWidth / 2,
+        controlsWidth / 2 - sliderWidth / 2,
         yMargin*2 + sliderHeight,
         sliderWidth, 
         sliderHeight);
     gainSlider.setBounds(
-        getWidth() - sliderWidth - xMargin, 
+        controlsWidth - sliderWidth - xMargin, 
         yMargin*2 + sliderHeight, 
         sliderWidth, 
         sliderHeight);
@@ -162,6 +215,6 @@ void TapSynthAudioProcessorEditor::resized()
     dimensionSlider.setBounds(
         xMargin,
         yMargin * 3 + sliderHeight * 2,
-        getWidth() - xMargin * 2,
+        controlsWidth - xMargin * 2,
         sliderHeight);
 }
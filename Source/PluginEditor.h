@@ -10,11 +10,13 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "ScenePad.h"
 
 //==============================================================================
 /**
 */
-class TapSynthAudioProcessorEditor  : public juce::AudioProcessorEditor
+class TapSynthAudioProcessorEditor  : public juce::AudioProcessorEditor,
+                                      private juce::Timer
 {
 public:
     TapSynthAudioProcessorEditor (TapSynthAudioProcessor&);
@@ -25,11 +27,24 @@ public:
     void resized() override;
 
 private:
+    // Picks up scenes that a recalled session or preset put in place, and the profile
+    void timerCallback() override;
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     TapSynthAudioProcessor& audioProcessor;
 
     float heigth = 500, width = 400;
+    const int padSize = 360;
+
+    // Top view of the scene, drag sources around in 2D
+    ScenePad scenePad;
+    juce::Label scenePadLabel;
+    juce::TextButton splineFromSceneButton;
+    juce::uint32 sceneVersion = 0;
+
+    // Where the audio thread's time goes, only there when profiling is compiled in
+    juce::Label profileLabel;
 
     // Min Slider
     juce::Slider minFreqSlider;
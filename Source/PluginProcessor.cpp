@@ -9,9 +9,10 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 #include "SynthParameters.h"
+#include "AudioThreadGuard.h"
 
 //==============================================================================
-TapSynthAudioProcessor::TapSynthAudioProcessor()
+TapSynthAudioProcessor::TapSynthAudioProcessor(int numVoices)
 #ifndef JucePlugin_PreferredChannelConfigurations
     : AudioProcessor(BusesProperties()
 #if ! JucePlugin_IsMidiEffect
@@ -19,18 +20,79 @@ TapSynthAudioProcessor::TapSynthAudioProcessor()
         .withInput("Input", juce::AudioChannelSet::stereo(), false)
 #endif
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+        .withOutput("Ambisonics", juce::AudioChannelSet::ambisonic(1), false)
 #endif
-    )
+    ),
+#else
+    :
 #endif
+    spatialState(numVoices),
+    oscillators(spatialState.getNumVoices()),
+    noise(spatialState.getNumVoices()),
+    modulation(spatialState.getNumVoices()),
+    synth(oscillators, noise)
 {
     synth.addSound(new SynthSound());
-    synth.addVoice(new SynthVoice());
+    synth.setWorkerPool(&renderPool);
+    spatialState.setWorkerPool(&renderPool);
+    spatialState.setProfiler(&profiler);
+
+    // The whole pool is created up front, each voice bound to its own spatial slot and oscillator lane
+    for (int i = 0; i < spatialState.getNumVoices(); ++i)
+        synth.addSynthVoice(new SynthVoice(i, spatialState, oscillators, noise, modulation));
 
     apvts.reset(new juce::AudioProcessorValueTreeState(*this, nullptr, "Parameters", createParameters()));
+
+    // Pitch and gain glide, positions don't need to: the ITD engine already ramps its delays
+    minFreqParam = parameters.add(*apvts, "minFreq", 0.05);
+    maxFreqParam = parameters.add(*apvts, "maxFreq", 0.05);
+    lfoSpeedParam = parameters.add(*apvts, "lfoSpeed");
+    xParam = parameters.add(*apvts, "x");
+    yParam = parameters.add(*apvts, "y");
+    gainParam = parameters.add(*apvts, "gain", 0.02);
+    dimensionParam = parameters.add(*apvts, "dimension");
+    interpolationParam = parameters.add(*apvts, "interpolation");
+    hrtfParam = parameters.add(*apvts, "hrtf");
+    waveformParam = parameters.add(*apvts, "waveform");
+    lfoShapeParam = parameters.add(*apvts, "lfoShape");
+    trajectoryParam = parameters.add(*apvts, "trajectory");
+    trajectorySizeParam = parameters.add(*apvts, "trajectorySize", 0.05);
+    trajectoryRateParam = parameters.add(*apvts, "trajectoryRate");
+    trajectorySyncParam = parameters.add(*apvts, "trajectorySync");
+    trajectoryBeatsParam = parameters.add(*apvts, "trajectoryBeats");
+    oversamplingParam = parameters.add(*apvts, "oversampling");
+    oversamplingModeParam = parameters.add(*apvts, "oversamplingMode");
+    reflectionOrderParam = parameters.add(*apvts, "reflectionOrder");
+    reflectivityParam = parameters.add(*apvts, "reflectivity");
+    reverbSendParam = parameters.add(*apvts, "reverbSend", 0.05);
+    reverbLinesParam = parameters.add(*apvts, "reverbLines");
+    renderThreadsParam = parameters.add(*apvts, "renderThreads");
+    beatsParam = parameters.add(*apvts, "beats");
+    beatCarrierParam = parameters.add(*apvts, "beatCarrier");
+    beatFrequencyParam = parameters.add(*apvts, "beatFrequency");
+    beatLayersParam = parameters.add(*apvts, "beatLayers");
+    beatSpreadParam = parameters.add(*apvts, "beatSpread");
+    beatLevelParam = parameters.add(*apvts, "beatLevel");
+    noiseParam = parameters.add(*apvts, "noise");
+    noiseSeedParam = parameters.add(*apvts, "noiseSeed");
+
+    for (auto* voice : synth.getSynthVoices())
+        voice->updateParams(parameters, gainParam);
+
+    presets.onPresetLoaded = [this](const PresetBank::LoadedPreset& preset) { applyState(preset.state, &preset.splinePath); };
+
+    // Same pattern the old wall-clock sequencer played: a one step note on steps 3 and 9 of 10
+    sequencer.setMidiChannel(midiChannel);
+    sequencer.setNumSteps(10);
+    for (int step : { 3, 9 })
+        sequencer.getStep(step) = { true, midiNoteNumber, velocity, 1 };
+
+    startTimerHz(20);
 }
 
 TapSynthAudioProcessor::~TapSynthAudioProcessor()
 {
+    stopTimer();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout TapSynthAudioProcessor::createParameters()
@@ -43,6 +105,16 @@ juce::AudioProcessorValueTreeState::ParameterLayout TapSynthAudioProcessor::crea
         juce::NormalisableRange<float>(0.1f, 5.0f, 0.01f),  // Rango: 0.1Hz a 5Hz
         0.5f));  // Valor por defecto: 0.5Hz (ciclo cada 2 segundos)
 
+    // Shape of the pitch sweep, in the order of ModulationEngine::Shape
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "lfoShape", "LFO Shape",
+        juce::StringArray{ "Sine", "Triangle", "Saw", "Square" }, 0));
+
+    // Band-limited wavetables, every waveform is alias-free across the frequency range
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "waveform", "Waveform",
+        juce::StringArray{ "Sine", "Square", "Saw", "Triangle" }, 0));
+
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "minFreq", "Minimum Frequency",
         juce::NormalisableRange<float>(50.0f, 4000.0f, 1.0f), 500.0f));
@@ -65,7 +137,104 @@ juce::AudioProcessorValueTreeState::ParameterLayout TapSynthAudioProcessor::crea
 
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "dimension", "Dimension",
-        juce::NormalisableRange<float>(0.1f, 10.0f, 0.1f), 1.0f));
+        juce::NormalisableRange<float>(0.1f, maxDimension, 0.1f), 1.0f));
+
+    // Fractional delay interpolation of the ITD delay lines
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "interpolation", "Delay Interpolation",
+        juce::StringArray{ "Linear", "Lagrange 3", "Lagrange 5", "Thiran" }, 1));
+
+    // Off runs the same convolution with an identity filter, so the latency doesn't change
+    params.push_back(std::make_unique<juce::AudioParameterBool>("hrtf", "HRTF", true));
+
+    // Built-in motion, every source loops around its own position
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "trajectory", "Trajectory",
+        juce::StringArray{ "Off", "Circle", "Ellipse", "Figure 8", "Spline", "Random Walk" }, 0));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "trajectorySize", "Trajectory Size",
+        juce::NormalisableRange<float>(0.0f, 50.0f, 0.5f), 25.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "trajectoryRate", "Trajectory Rate",
+        juce::NormalisableRange<float>(0.01f, 2.0f, 0.01f, 0.5f), 0.2f));  // cycles per second
+
+    // Synced, one cycle takes trajectoryBeats beats of the host's tempo instead
+    params.push_back(std::make_unique<juce::AudioParameterBool>("trajectorySync", "Trajectory Sync", false));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "trajectoryBeats", "Trajectory Beats",
+        juce::StringArray{ "1", "2", "4", "8", "16" }, 2));
+
+    // Runs the delays and HRIRs oversampled, fewer interpolation artefacts on fast moves
+    // for more CPU and latency. Changing it re-prepares the spatial stage.
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "oversampling", "Oversampling",
+        juce::StringArray{ "1x", "2x", "4x", "8x" }, 0));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "oversamplingMode", "Oversampling Filters",
+        juce::StringArray{ "Polyphase IIR", "Linear Phase FIR" }, 0));
+
+    // Early reflections off the walls of the box, up to this many bounces. Changing it
+    // re-prepares the spatial stage, higher orders need longer delay lines.
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "reflectionOrder", "Reflections",
+        juce::StringArray{ "Off", "1st Order", "2nd Order", "3rd Order" }, 0));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "reflectivity", "Wall Reflectivity",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.6f));
+
+    // Late reverb of the box, one send shared by every voice
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "reverbSend", "Reverb Send",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "reverbLines", "Reverb Density",
+        juce::StringArray{ "8 Lines", "16 Lines" }, 0));
+
+    // Threads rendering the voices, the audio thread included. The output is the same with
+    // any number, only the CPU load is spread differently. Changing it re-prepares.
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "renderThreads", "Render Threads",
+        juce::StringArray{ "1", "2", "4", "8" }, 0));
+
+    // Binaural beats under everything else: layers of carriers spread upwards from
+    // beatCarrier, each ear beatFrequency apart
+    params.push_back(std::make_unique<juce::AudioParameterBool>("beats", "Binaural Beats", false));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "beatCarrier", "Beat Carrier",
+        juce::NormalisableRange<float>(40.0f, 1000.0f, 0.1f, 0.4f), 200.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "beatFrequency", "Beat Frequency",
+        juce::NormalisableRange<float>(0.5f, 40.0f, 0.01f, 0.5f), 10.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "beatLayers", "Beat Layers",
+        juce::NormalisableRange<float>(1.0f, (float)BinauralBeatBank::maxLayers, 1.0f), 1.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "beatSpread", "Beat Layer Spread",
+        juce::NormalisableRange<float>(0.0f, 12.0f, 0.01f), 7.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "beatLevel", "Beat Level",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.25f));
+
+    // Noise in place of the oscillators, placed and moved like them. Band noise follows
+    // the pitch sweep. The same seed renders the same noise every time.
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "noise", "Noise Source",
+        juce::StringArray{ "Off", "White", "Pink", "Brown", "Band" }, 0));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "noiseSeed", "Noise Seed",
+        juce::NormalisableRange<float>(0.0f, 9999.0f, 1.0f), 0.0f));
 
     return { params.begin(), params.end() };
 }
@@ -105,27 +274,36 @@ bool TapSynthAudioProcessor::isMidiEffect() const
 
 double TapSynthAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // The notes' release, then the furthest source, its HRIRs and the room: as long as
+    // that after the last note off the output can still be sounding
+    const double release = synth.getSynthVoices().isEmpty() ? 0.0 : synth.getSynthVoices().getFirst()->getReleaseSeconds();
+
+    return release + spatialState.getTailLengthSeconds(apvts->getRawParameterValue("dimension")->load(),
+                                                       apvts->getRawParameterValue("reflectivity")->load(),
+                                                       apvts->getRawParameterValue("reverbSend")->load() > 0.0f);
 }
 
 int TapSynthAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+    return juce::jmax(1, presets.getNumPresets());   // NB: some hosts don't cope very well if you tell them there are 0 programs,
     // so this should be at least 1, even if you're not really implementing programs.
 }
 
 int TapSynthAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram;
 }
 
 void TapSynthAudioProcessor::setCurrentProgram(int index)
 {
+    // Parsed and built in the background, applied when it's ready
+    currentProgram = index;
+    presets.loadPreset(index);
 }
 
 const juce::String TapSynthAudioProcessor::getProgramName(int index)
 {
-    return {};
+    return presets.getPresetName(index);
 }
 
 void TapSynthAudioProcessor::changeProgramName(int index, const juce::String& newName)
@@ -137,40 +315,172 @@ void TapSynthAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBloc
 {
     synth.setCurrentPlaybackSampleRate(sampleRate);
 
-    for (int i = 0; i < synth.getNumVoices(); ++i)
+    // Everything after the FIFO only ever sees micro-blocks, the host's block size
+    // just sizes the FIFO
+    for (auto* voice : synth.getSynthVoices())
+        voice->prepareToPlay(sampleRate, microBlockSize);
+
+    oscillators.prepare(sampleRate, microBlockSize);
+    noise.prepare(sampleRate, microBlockSize);
+    modulation.prepare(sampleRate, microBlockSize);
+
+    parameters.prepare(sampleRate, microBlockSize);
+
+    // Preparing counts as a move of the X/Y sliders, which would send new notes back to
+    // them; the pad's scene goes out again so it's still what they play
     {
-        if (auto* voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
-            voice->prepareToPlay(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
+        const juce::SpinLock::ScopedLockType lock(publishLock);
+        if (scenePublished)
+        {
+            sceneExchange.getWriteBuffer() = editorScene;
+            sceneExchange.publish();
+        }
     }
 
+    currentSampleRate = sampleRate;
+    prepareSpatial(sampleRate, microBlockSize);
+    beatBank.prepare(sampleRate, microBlockSize);
+    profiler.prepare(sampleRate);
+
+    sequencer.prepare(sampleRate);
+    sequencedMidi.ensureSize(4096);
+    pendingMidi.ensureSize(4096);
+    microBlockMidi.ensureSize(4096);
+    remainingMidi.ensureSize(4096);
+    pendingMidi.clear();
+
+    // Starts one micro-block of silence ahead, which is the latency
+    maxHostBlockSize = juce::jmax(1, samplesPerBlock);
+    outputFifo.setSize(2 + spatialState.getNumAmbisonicChannels(), maxHostBlockSize + microBlockSize);
+    outputFifo.clear();
+    fifoReady = microBlockSize;
+
     // Play C4 on start:
     synth.noteOn(midiChannel, midiNoteNumber, velocity);
+}
+
+
+void TapSynthAudioProcessor::prepareSpatial(double sampleRate, int samplesPerBlock)
+{
+    // Straight from the APVTS, this also runs on the message thread
+    preparedOversampling = (int)apvts->getRawParameterValue("oversampling")->load();
+    preparedLinearPhase = apvts->getRawParameterValue("oversamplingMode")->load() >= 0.5f;
+    preparedReflectionOrder = (int)apvts->getRawParameterValue("reflectionOrder")->load();
+    preparedThreads = (int)apvts->getRawParameterValue("renderThreads")->load();
+    preparedBlockSize = samplesPerBlock;
+
+    // Delay lines and per-voice buffers for the whole pool. The HRIR set is shared
+    // with every other instance that has it open, and has to be for the oversampled rate.
+    spatialState.setOversampling(preparedOversampling, preparedLinearPhase);
+    spatialState.setReflectionOrder(preparedReflectionOrder);
+    spatialState.setAmbisonicOrder(getAmbisonicOrder());
+    renderPool.setNumThreads(1 << preparedThreads);
+    spatialState.setHrtfDatabase(HrtfDatabase::open(getHrtfFile(SpatialVoiceState::getInternalSampleRate(sampleRate, preparedOversampling))));
+    spatialState.prepare(sampleRate, samplesPerBlock, maxDimension);
+    setLatencySamples(spatialState.getLatencySamples() + microBlockSize);
+}
+
+void TapSynthAudioProcessor::timerCallback()
+{
+    if (!spatialChanged.exchange(false) || preparedBlockSize == 0)
+        return;
+
+    // The audio callback is held off while the spatial stage is rebuilt
+    suspendProcessing(true);
+    prepareSpatial(currentSampleRate, preparedBlockSize);
+    suspendProcessing(false);
+}
+
+int TapSynthAudioProcessor::getAmbisonicOrder() const
+{
+    // Off unless the host turned the bus on
+    auto* bus = getBus(false, 1);
+    return bus != nullptr && bus->isEnabled() ? juce::jmax(0, bus->getCurrentLayout().getAmbisonicOrder()) : 0;
+}
+
+juce::File TapSynthAudioProcessor::getHrtfFile(double sampleRate) const
+{
+    if (hrtfFile != juce::File())
+        return hrtfFile;
+
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("Binaural Rays")
+        .getChildFile("hrtf_" + juce::String(juce::roundToInt(sampleRate)) + ".brht");
+}
+
+void TapSynthAudioProcessor::publishScene(const SceneSnapshot& scene)
+{
+    const juce::SpinLock::ScopedLockType lock(publishLock);
+    editorScene = scene;
+    scenePublished = true;
+    sceneExchange.getWriteBuffer() = scene;
+    sceneExchange.publish();
+}
+
+void TapSynthAudioProcessor::setTrajectoryPoints(const juce::Point<float>* points, int numPoints)
+{
+    numPoints = juce::jlimit(0, TrajectoryEngine::maxSplinePoints, numPoints);
 
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = 2;
+    const juce::SpinLock::ScopedLockType lock(publishLock);
+    trajectoryPoints.assign(points, points + numPoints);
+    spatialState.getTrajectories().setSplinePoints(points, numPoints);
+}
 
-    // Delay code:
-    delayLineL.reset(); // left channel
-    delayLineR.reset(); // right channel
-    delayLineL.prepare(spec);
-    delayLineR.prepare(spec);
+PluginState TapSynthAudioProcessor::captureState() const
+{
+    PluginState state;
 
-    // Resize 
-    delayLineL.setMaximumDelayInSamples((int)(sampleRate * 2.0)); // delay max seconds 
-    delayLineR.setMaximumDelayInSamples((int)(sampleRate * 2.0));
+    for (auto* parameter : getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            state.parameters.push_back({ ranged->paramID, ranged->convertFrom0to1(ranged->getValue()) });
 
-    delayLineL.setDelay(0.01);
-    delayLineR.setDelay(0.01);
+    const juce::SpinLock::ScopedLockType lock(publishLock);
+    state.scene = editorScene;
+    state.splinePoints = trajectoryPoints;
+    return state;
+}
+
+void TapSynthAudioProcessor::applyState(const PluginState& state, const TrajectoryEngine::Path* prebuiltSpline)
+{
+    // Parameters the state doesn't know about go back to their defaults
+    for (auto* parameter : getParameters())
+    {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+        if (ranged == nullptr)
+            continue;
+
+        auto value = ranged->getDefaultValue();
+
+        for (const auto& stored : state.parameters)
+        {
+            if (stored.id == ranged->paramID)
+            {
+                value = ranged->convertTo0to1(stored.value);
+                break;
+            }
+        }
+
+        ranged->setValueNotifyingHost(value);
+    }
+
+    {
+        const juce::SpinLock::ScopedLockType lock(publishLock);
+        trajectoryPoints = state.splinePoints;
+
+        if (prebuiltSpline != nullptr)
+            spatialState.getTrajectories().setSplinePath(*prebuiltSpline);
+        else
+            spatialState.getTrajectories().setSplinePoints(trajectoryPoints.data(), (int)trajectoryPoints.size());
+    }
 
-    // Psychoacoustic gain
-    gainL.prepare(spec);
-    gainL.setGainLinear(1.0f);
-    gainR.prepare(spec);
-    gainR.setGainLinear(1.0f);
+    publishScene(state.scene);
+    ++sceneVersion;
 }
 
+int TapSynthAudioProcessor::savePreset(const juce::String& name)
+{
+    return presets.savePreset(name, captureState());
+}
 
 void TapSynthAudioProcessor::releaseResources()
 {
@@ -193,6 +503,16 @@ bool TapSynthAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts)
         && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
         return false;
 
+    // The ambisonic bus is optional, 1st to 3rd order
+    if (layouts.outputBuses.size() > 1)
+    {
+        const auto& ambisonics = layouts.outputBuses.getReference(1);
+
+        if (!ambisonics.isDisabled()
+            && (ambisonics.getAmbisonicOrder() < 1 || ambisonics.getAmbisonicOrder() > AmbisonicEncoder::maxOrder))
+            return false;
+    }
+
     // This checks if the input layout matches the output layout
 #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
@@ -206,98 +526,200 @@ bool TapSynthAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts)
 
 void TapSynthAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    minFreq = apvts->getRawParameterValue("minFreq")->load();
-    maxFreq = apvts->getRawParameterValue("maxFreq")->load();
-    lfoSpeed = apvts->getRawParameterValue("lfoSpeed")->load();
-    horizontalPosition = apvts->getRawParameterValue("x")->load();
-    verticalPosition = apvts->getRawParameterValue("y")->load();
-    zDepth = apvts->getRawParameterValue("gain")->load();
-    dimension = apvts->getRawParameterValue("dimension")->load();
-
-    // Distance from 0 to 141,42 (diagonal from 100 to 100)
-    lDistance = sqrt(juce::square(horizontalPosition - leftEarX) + juce::square(leftEarY - verticalPosition));
-    rDistance = sqrt(juce::square(horizontalPosition - rightEarX) + juce::square(rightEarY - verticalPosition));
-
-    // Normalized distance relative to the maxDistance, from 0 to 100:
-    float maxDistanceToEar = sqrt(juce::square(maxDistance - leftEarX) + juce::square(maxDistance - leftEarY));
-    lDistance = 100 * lDistance / maxDistanceToEar;
-    rDistance = 100 * rDistance / maxDistanceToEar;
-
-    // Distance in meters:
-    lDistance = lDistance * dimension/100;
-    rDistance = rDistance * dimension/100;
-
-    float leftD = (currentSampleRate / 1000.0f)* lDistance*343;
-    float rightD = (currentSampleRate / 1000.0f)* rDistance*343;
-    
-    delayLineL.setDelay(leftD);
-    delayLineR.setDelay(rightD);
-    float gainLValue = (maxDistance - lDistance) / maxDistance;
-    float gainRValue = (maxDistance - rDistance) / maxDistance;
-    //gainL.setGainLinear(gainLValue);
-    //gainR.setGainLinear(gainRValue);
-
-    // Primitive sequencer
-    msCount = time.getMillisecondCounterHiRes();
-    msCount = ((msCount % 1000) / 100);
-    if (msCount % 2 == 0) {
-        synth.noteOff(midiChannel, midiNoteNumber, velocity, true);
-    }
-    else if (msCount % 3 == 0) {
-        synth.noteOn(midiChannel, midiNoteNumber, velocity);
-    }
-
+    // Nothing below may allocate, debug builds abort if it does. The locks that are
+    // left are listed in AudioThreadGuard.h.
+    AudioThreadGuard::ScopedGuard realtimeGuard;
     juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
 
     const int numSamples = buffer.getNumSamples();
-    float currentFreq;
+    profiler.beginBlock(numSamples);
 
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+    // Hosts may send more than they announced, the FIFO takes that much at a time
+    for (int start = 0; start < numSamples; start += maxHostBlockSize)
+        processHostSlice(buffer, midiMessages, start, juce::jmin(maxHostBlockSize, numSamples - start));
+
+    profiler.endBlock();
+}
+
+void TapSynthAudioProcessor::processHostSlice(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages,
+                                              int startSample, int numSamples) noexcept
+{
+    // Sequencer notes are merged with the host's at exact sample offsets
     {
-        buffer.clear(i, 0, numSamples);
+        BINAURAL_RAYS_PROFILE(&profiler, midi);
+        sequencedMidi.clear();
+        sequencedMidi.addEvents(midiMessages, startSample, numSamples, -startSample);
+        sequencer.process(getPlayHead(), numSamples, sequencedMidi);
+
+        // The FIFO is fifoReady samples ahead of the host, the next micro-block starts
+        // that much before the host's block plus the one block of latency
+        pendingMidi.addEvents(sequencedMidi, 0, numSamples, microBlockSize - fifoReady);
     }
 
-    // Send parameters to the Synth's voice:
-    for (int i = 0; i < synth.getNumVoices(); ++i)
+    // Motion paths free-run at trajectoryRate, or when synced take trajectoryBeats
+    // beats per cycle and follow the host's position while it plays
+    double cyclesPerSecond = parameters.get(trajectoryRateParam);
+    double syncedPosition = 0.0;
+    bool synced = false;
+
+    if (parameters.get(trajectorySyncParam) >= 0.5f && getPlayHead() != nullptr)
     {
-        if (auto* voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
+        if (const auto position = getPlayHead()->getPosition())
         {
-            voice->updateParams(*apvts);
+            const double beatsPerCycle = (double)(1 << (int)parameters.get(trajectoryBeatsParam));
+            const auto bpm = position->getBpm();
+            const auto ppq = position->getPpqPosition();
+
+            if (bpm.hasValue() && *bpm > 0.0)
+                cyclesPerSecond = *bpm / 60.0 / beatsPerCycle;
+
+            if (position->getIsPlaying() && ppq.hasValue())
+            {
+                syncedPosition = *ppq / beatsPerCycle;
+                synced = true;
+            }
         }
     }
 
-    synth.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+    // Render only once the host has sent all the MIDI of a micro-block, which it has for
+    // every one that starts before the end of its block less the latency. The FIFO has
+    // the binaural pair first, then the ambisonic channels.
+    auto mainBus = getBusBuffer(buffer, false, 0);
+    const int numChannels = juce::jlimit(1, 2, mainBus.getNumChannels());
+    const int numAmbisonicChannels = spatialState.getNumAmbisonicChannels();
 
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    while (fifoReady < numSamples)
     {
-        auto* channelData = buffer.getWritePointer(channel);
+        // Where this micro-block starts relative to the host's block, for the sync
+        const double offsetSeconds = (fifoReady - microBlockSize) / currentSampleRate;
+        juce::AudioBuffer<float> block(outputFifo.getArrayOfWritePointers(), numChannels, fifoReady, microBlockSize);
 
-        float gain = (channel == 0) ? gainLValue : gainRValue;
+        for (int channel = 0; channel < numAmbisonicChannels; ++channel)
+            ambisonicChannels[(size_t)channel] = outputFifo.getWritePointer(2 + channel, fifoReady);
 
-        buffer.applyGain(channel, 0, buffer.getNumSamples(), gain);
+        // The synth plays every event it's given, clamping late ones to the end of the
+        // block, so it only gets this micro-block's
+        microBlockMidi.clear();
+        microBlockMidi.addEvents(pendingMidi, 0, microBlockSize, 0);
 
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        renderMicroBlock(block, ambisonicChannels.data(), cyclesPerSecond, synced, syncedPosition + offsetSeconds * cyclesPerSecond);
+        synced = false;
+
+        // Whatever is left is for the next micro-blocks
+        remainingMidi.clear();
+        remainingMidi.addEvents(pendingMidi, microBlockSize, -1, -microBlockSize);
+        pendingMidi.swapWith(remainingMidi);
+
+        fifoReady += microBlockSize;
+    }
+
+    buffer.clear(startSample, numSamples);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        mainBus.copyFrom(channel, startSample, outputFifo, channel, 0, numSamples);
+
+    // Only there if the host turned the bus on with the order we were prepared for
+    auto ambisonicBus = getBusBuffer(buffer, false, 1);
+    if (numAmbisonicChannels > 0 && ambisonicBus.getNumChannels() == numAmbisonicChannels)
+        for (int channel = 0; channel < numAmbisonicChannels; ++channel)
+            ambisonicBus.copyFrom(channel, startSample, outputFifo, 2 + channel, 0, numSamples);
+
+    // Less than a micro-block stays behind, moved to the front
+    fifoReady -= numSamples;
+
+    for (int channel = 0; channel < outputFifo.getNumChannels(); ++channel)
+    {
+        auto* samples = outputFifo.getWritePointer(channel);
+        std::copy(samples + numSamples, samples + numSamples + fifoReady, samples);
+    }
+}
+
+void TapSynthAudioProcessor::renderMicroBlock(juce::AudioBuffer<float>& block, float* const* ambisonicChannels,
+                                              double cyclesPerSecond, bool synced, double syncedPosition) noexcept
+{
+    const int numSamples = block.getNumSamples();
+
+    {
+        BINAURAL_RAYS_PROFILE(&profiler, parameters);
+        parameters.update(numSamples);
+
+        // New notes start where the X/Y sliders are
+        const auto newPositionVersion = parameters.getVersion(xParam) + parameters.getVersion(yParam);
+        if (newPositionVersion != positionVersion)
         {
-            float inputSample = channelData[sample];
-
-            float delayedSample = (channel == 0)
-                ? delayLineL.popSample(0)
-                : delayLineR.popSample(0);
-
-            // Mixed signal: 
-            // channelData[sample] = inputSample + 0.5f * delayedSample;
-            // Wet signal: 
-            channelData[sample] =  delayedSample;
-
-            // Push new sample into delay buffer
-            if (channel == 0) {
-                delayLineL.pushSample(0, inputSample);
-            } else {
-                delayLineR.pushSample(0, inputSample);
-            }
+            spatialState.setNextNotePosition(parameters.get(xParam), parameters.get(yParam));
+            positionVersion = newPositionVersion;
         }
+
+        // A scene from the pad moves all the voices together, it never arrives half updated
+        if (sceneExchange.update())
+            spatialState.applyScene(sceneExchange.getReadBuffer());
+
+        if (parameters.getVersion(dimensionParam) != dimensionVersion)
+        {
+            spatialState.setDimension(parameters.get(dimensionParam));
+            dimensionVersion = parameters.getVersion(dimensionParam);
+        }
+
+        // Only voices that moved, or all of them after a dimension change, redo the distance math
+        spatialState.setInterpolation((ItdDelayEngine::Interpolation)(int)parameters.get(interpolationParam));
+        spatialState.setHrtfEnabled(parameters.get(hrtfParam) >= 0.5f);
+        oscillators.setWaveform((WavetableSet::Waveform)(int)parameters.get(waveformParam));
+        noise.setColour((NoiseBank::Colour)(int)parameters.get(noiseParam));
+
+        if ((juce::uint32)parameters.get(noiseSeedParam) != noise.getSeed())
+            noise.setSeed((juce::uint32)parameters.get(noiseSeedParam));
+
+        // Every voice sweeps sample by sample between the smoothed limits, lfoSpeed cycles per second
+        const float lfoSpeed = parameters.get(lfoSpeedParam);
+        modulation.setParameters(parameters.getBlock(minFreqParam), parameters.getBlock(maxFreqParam), lfoSpeed,
+                                 (ModulationEngine::Shape)(int)parameters.get(lfoShapeParam));
+        // Oversampling and the delay lines can't be reallocated here, the message thread
+        // rebuilds the spatial stage
+        if ((int)parameters.get(oversamplingParam) != preparedOversampling
+            || (parameters.get(oversamplingModeParam) >= 0.5f) != preparedLinearPhase
+            || (int)parameters.get(reflectionOrderParam) != preparedReflectionOrder
+            || (int)parameters.get(renderThreadsParam) != preparedThreads)
+            spatialChanged.store(true);
+
+        spatialState.setReflectivity(parameters.get(reflectivityParam));
+        spatialState.setReverb(parameters.get(reverbSendParam), parameters.get(reverbLinesParam) >= 0.5f ? 16 : 8);
+
+        spatialState.updateGeometry();
+
+        auto& trajectories = spatialState.getTrajectories();
+        trajectories.setParameters((TrajectoryEngine::Shape)(int)parameters.get(trajectoryParam),
+                                   parameters.get(trajectorySizeParam), cyclesPerSecond);
+        if (synced)
+            trajectories.syncPosition(syncedPosition);
+
+        // Turning the beats off fades them out over the next micro-block
+        beatBank.setStack(parameters.get(beatsParam) >= 0.5f ? (int)parameters.get(beatLayersParam) : 0,
+                          parameters.get(beatCarrierParam), parameters.get(beatFrequencyParam),
+                          parameters.get(beatSpreadParam), parameters.get(beatLevelParam));
+    }
+
+    // Voices render mono into their own slots, then each one is delayed and
+    // panned by its own position and summed into the output
+    spatialState.clearVoiceBuffers(numSamples);
+
+    {
+        BINAURAL_RAYS_PROFILE(&profiler, oscillators);
+        synth.renderNextBlock(block, microBlockMidi, 0, numSamples);
+    }
+
+    block.clear();
+    spatialState.process(block, numSamples);
+
+    {
+        // Straight to the ears, a carrier panned by the spatial stage would reach both
+        BINAURAL_RAYS_PROFILE(&profiler, beats);
+        beatBank.process(block.getWritePointer(0), block.getNumChannels() > 1 ? block.getWritePointer(1) : nullptr, numSamples);
+    }
+
+    {
+        BINAURAL_RAYS_PROFILE(&profiler, ambisonics);
+        spatialState.encodeAmbisonics(ambisonicChannels, numSamples);
     }
 }
 
@@ -316,15 +738,15 @@ juce::AudioProcessorEditor* TapSynthAudioProcessor::createEditor()
 //==============================================================================
 void TapSynthAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    juce::MemoryOutputStream output(destData, false);
+    captureState().write(output);
 }
 
 void TapSynthAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    PluginState state;
+    if (state.read(data, (size_t)juce::jmax(0, sizeInBytes)))
+        applyState(state);
 }
 
 //==============================================================================
@@ -11,16 +11,34 @@
 #include <JuceHeader.h>
 #include "SynthSound.h"
 #include "SynthVoice.h"
+#include "TapSynthesiser.h"
+#include "WavetableOscillator.h"
+#include "NoiseBank.h"
+#include "ModulationEngine.h"
+#include "SpatialVoiceState.h"
+#include "NoteSequencer.h"
+#include "SynthParameters.h"
+#include "SceneSnapshot.h"
+#include "TripleBuffer.h"
+#include "PluginState.h"
+#include "PresetBank.h"
+#include "RealtimeWorkerPool.h"
+#include "DspProfiler.h"
+#include "BinauralBeatBank.h"
 
 
 //==============================================================================
 /**
 */
-class TapSynthAudioProcessor  : public juce::AudioProcessor
+class TapSynthAudioProcessor  : public juce::AudioProcessor,
+                                private juce::Timer
 {
 public:
     //==============================================================================
-    TapSynthAudioProcessor();
+    static constexpr int defaultNumVoices = SpatialVoiceState::minVoices;
+
+    // numVoices is clamped to the range the spatial state supports (16 to 512)
+    explicit TapSynthAudioProcessor(int numVoices = defaultNumVoices);
     ~TapSynthAudioProcessor() override;
 
     //==============================================================================
@@ -58,49 +76,125 @@ public:
 
     juce::AudioProcessorValueTreeState& getState() { return *apvts; }
 
+    // Measured HRIR set to load on the next prepareToPlay. By default it's
+    // "Binaural Rays/hrtf_<sample rate>.brht" in the user's application data folder.
+    void setHrtfFile(const juce::File& file) { hrtfFile = file; }
+    juce::File getHrtfFile(double sampleRate) const;
+
+    // Any thread but the audio thread. Hands a whole scene to the audio thread, which moves
+    // every voice to it at the start of its next block; scenes published in between are skipped.
+    void publishScene(const SceneSnapshot& scene);
+    const SceneSnapshot& getScene() const noexcept { return editorScene; }
+
+    // Bumped whenever a recalled state or preset replaces the scene, so the editor can follow
+    juce::uint32 getSceneVersion() const noexcept { return sceneVersion.load(); }
+
+    // Any thread but the audio thread. Control points of the "Spline" trajectory, in -1..1 around each source.
+    void setTrajectoryPoints(const juce::Point<float>* points, int numPoints);
+
+    // The whole recallable state, used by the session state and the presets. Applying
+    // it never waits on the audio thread: parameters go through the APVTS, the scene and
+    // the spline table through their triple buffers.
+    PluginState captureState() const;
+    void applyState(const PluginState& state, const TrajectoryEngine::Path* prebuiltSpline = nullptr);
+
+    // Presets are the host's programs. Saving writes the current state, returns its index.
+    PresetBank& getPresets() noexcept { return presets; }
+    int savePreset(const juce::String& name);
+
+    // Where processBlock's time goes, any thread can take a snapshot. Empty unless
+    // BINAURAL_RAYS_PROFILING is on.
+    DspProfiler& getProfiler() noexcept { return profiler; }
+
 private:
 
-    juce::Synthesiser synth;
-    juce::Time time;
-    juce::uint32 msCount;
+    // Upper end of the "dimension" parameter, sizes the voices' delay lines
+    static constexpr float maxDimension = 10.0f;
+
+    // Sets the spatial stage up for the current oversampling and reports its latency
+    void prepareSpatial(double sampleRate, int samplesPerBlock);
+
+    // A changed oversampling setting re-prepares the spatial stage here, on the message thread.
+    // The audio thread only raises spatialChanged, posting a message could lock or allocate.
+    void timerCallback() override;
+
+    // The synth and the spatial stage run on blocks of exactly microBlockSize samples,
+    // whatever the host sends. Its MIDI waits in pendingMidi until a whole micro-block of
+    // it is there, and the audio comes out of outputFifo, one micro-block late.
+    static constexpr int microBlockSize = 64;
+
+    // At most maxHostBlockSize samples of the host's block, from startSample
+    void processHostSlice(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages,
+                          int startSample, int numSamples) noexcept;
+    void renderMicroBlock(juce::AudioBuffer<float>& block, float* const* ambisonicChannels,
+                          double cyclesPerSecond, bool synced, double syncedPosition) noexcept;
+
+    // Of the optional second output bus, 0 while it's off
+    int getAmbisonicOrder() const;
+
+    RealtimeWorkerPool renderPool;      // outlives everything that renders on it
+    DspProfiler profiler;
+    SpatialVoiceState spatialState;
+    WavetableOscillatorBank oscillators;
+    NoiseBank noise;
+    ModulationEngine modulation;
+    TapSynthesiser synth;
+    BinauralBeatBank beatBank;
+
+    juce::File hrtfFile;
+
+    SceneSnapshot editorScene;                  // last scene published, for the editor
+    bool scenePublished = false;                // false until there is one
+    TripleBuffer<SceneSnapshot> sceneExchange;  // message thread to audio thread
+    std::atomic<juce::uint32> sceneVersion { 0 };
+    std::vector<juce::Point<float>> trajectoryPoints;  // for the state, empty is the default loop
+
+    // Only the writers take it, so the session state, presets and the editor can all
+    // publish; the audio thread never does
+    juce::SpinLock publishLock;
+
+    PresetBank presets;
+    int currentProgram = 0;
+
+    NoteSequencer sequencer;
+    juce::MidiBuffer sequencedMidi;   // host MIDI plus the sequencer's notes, preallocated
+    juce::MidiBuffer pendingMidi;     // not rendered yet, offsets from the next micro-block
+    juce::MidiBuffer microBlockMidi;  // the part of pendingMidi that falls in the next micro-block
+    juce::MidiBuffer remainingMidi;   // scratch for moving pendingMidi on
+
+    juce::AudioBuffer<float> outputFifo;
+    int fifoReady = 0;                // rendered samples at the front of outputFifo
+    std::array<float*, AmbisonicEncoder::maxChannels> ambisonicChannels {};
+    int maxHostBlockSize = 1;
     
     std::unique_ptr<juce::AudioProcessorValueTreeState> apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameters();
-    juce::dsp::DelayLine<float> delayLineL{ 48000 };
-    juce::dsp::DelayLine<float> delayLineR{ 48000 };
-    juce::dsp::Gain<float> gainL;
-    juce::dsp::Gain<float> gainR;
 
-    bool shouldPlayNote = true;
-    
-    float lfoPhase = 0.0f;
-    float squarePhase = 0.0f;
-    double currentSampleRate = 44100.0;
-    const float lfoFreq = 0.5f;
+    // Resolved once in the constructor so processBlock never looks parameters up by name
+    using Parameters = SynthParameters<float>;
+    Parameters parameters;
+    Parameters::Handle minFreqParam, maxFreqParam, lfoSpeedParam;
+    Parameters::Handle xParam, yParam, gainParam, dimensionParam, interpolationParam, hrtfParam, waveformParam, lfoShapeParam;
+    Parameters::Handle trajectoryParam, trajectorySizeParam, trajectoryRateParam, trajectorySyncParam, trajectoryBeatsParam;
+    Parameters::Handle oversamplingParam, oversamplingModeParam, reflectionOrderParam, reflectivityParam;
+    Parameters::Handle reverbSendParam, reverbLinesParam, renderThreadsParam;
+    Parameters::Handle beatsParam, beatCarrierParam, beatFrequencyParam, beatLayersParam, beatSpreadParam, beatLevelParam;
+    Parameters::Handle noiseParam, noiseSeedParam;
+    int preparedOversampling = 0;       // what the spatial stage was last prepared with
+    bool preparedLinearPhase = false;
+    int preparedReflectionOrder = 0;
+    int preparedThreads = 0;
+    int preparedBlockSize = 0;
+    std::atomic<bool> spatialChanged { false };
+    juce::uint32 positionVersion = 0;
+    juce::uint32 dimensionVersion = 0;
 
-    // Graphic parameters
-    float minFreq;
-    float maxFreq;
-    float lfoSpeed;
-    float horizontalPosition = 0.0f;
-    float verticalPosition = 20.0f;
-    float zDepth;
-    float dimension;
+    double currentSampleRate = 44100.0;
 
     const int midiChannel = 1;
     const int midiNoteNumber = 20; // C4
     const float velocity = 0.2f;
 
-    // maxDistance is the distance from the upper left to the upper right corner of the virtual square, 
-    // and all the other dimensions are derived from it. 
-    float maxDistance = 100.0f;
-    float rightEarX = (maxDistance / 2) + 0.2f * maxDistance;
-    float leftEarX = (maxDistance / 2) - 0.2f * maxDistance;
-    float rightEarY = 50;
-    float leftEarY = 50;
-    float rDistance;
-    float lDistance;
-
     
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TapSynthAudioProcessor)
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    PluginState.cpp
+    Created: 17 Oct 2026 7:15:32pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "PluginState.h"
+
+void PluginState::write(juce::OutputStream& output) const
+{
+    output.writeInt((int)magic);
+    output.writeInt((int)currentVersion);
+
+    output.writeCompressedInt((int)parameters.size());
+    for (const auto& parameter : parameters)
+    {
+        output.writeString(parameter.id);
+        output.writeFloat(parameter.value);
+    }
+
+    output.writeCompressedInt(scene.numSources);
+    for (int s = 0; s < scene.numSources; ++s)
+    {
+        output.writeFloat(scene.positions[(size_t)s].x);
+        output.writeFloat(scene.positions[(size_t)s].y);
+    }
+
+    output.writeCompressedInt((int)splinePoints.size());
+    for (const auto& point : splinePoints)
+    {
+        output.writeFloat(point.x);
+        output.writeFloat(point.y);
+    }
+}
+
+namespace
+{
+    // Streams read 0 past their end, so every section is checked for room first
+    bool hasBytes(juce::InputStream& input, juce::int64 numBytes)
+    {
+        return input.getNumBytesRemaining() >= numBytes;
+    }
+
+    bool readCount(juce::InputStream& input, int& count)
+    {
+        if (input.isExhausted())
+            return false;
+
+        count = input.readCompressedInt();
+        return true;
+    }
+
+    bool readPoint(juce::InputStream& input, juce::Point<float>& point)
+    {
+        point.x = input.readFloat();
+        point.y = input.readFloat();
+        return std::isfinite(point.x) && std::isfinite(point.y);
+    }
+}
+
+bool PluginState::read(juce::InputStream& input)
+{
+    if (!hasBytes(input, 8) || (juce::uint32)input.readInt() != magic)
+        return false;
+
+    if ((juce::uint32)input.readInt() < 1)
+        return false;
+
+    PluginState result;
+
+    // Counts are checked against what's left, a corrupt file can't make us allocate gigabytes
+    int numParameters = 0;
+    if (!readCount(input, numParameters) || numParameters < 0 || numParameters > input.getNumBytesRemaining())
+        return false;
+
+    result.parameters.resize((size_t)numParameters);
+    for (auto& parameter : result.parameters)
+    {
+        // An ID is at least one character and its terminator
+        if (!hasBytes(input, 2 + 4))
+            return false;
+
+        parameter.id = input.readString();
+        if (parameter.id.isEmpty() || !hasBytes(input, 4))
+            return false;
+
+        parameter.value = input.readFloat();
+        if (!std::isfinite(parameter.value))
+            return false;
+    }
+
+    int numSources = 0;
+    if (!readCount(input, numSources) || numSources < 1 || numSources > SceneSnapshot::maxSources
+        || !hasBytes(input, numSources * 8))
+        return false;
+
+    result.scene.numSources = numSources;
+    for (int s = 0; s < numSources; ++s)
+    {
+        juce::Point<float> position;
+        if (!readPoint(input, position))
+            return false;
+
+        result.scene.positions[(size_t)s] = { juce::jlimit(SceneSnapshot::minCoordinate, SceneSnapshot::maxCoordinate, position.x),
+                                              juce::jlimit(SceneSnapshot::minCoordinate, SceneSnapshot::maxCoordinate, position.y) };
+    }
+
+    int numSplinePoints = 0;
+    if (!readCount(input, numSplinePoints) || numSplinePoints < 0 || numSplinePoints > TrajectoryEngine::maxSplinePoints
+        || !hasBytes(input, numSplinePoints * 8))
+        return false;
+
+    result.splinePoints.resize((size_t)numSplinePoints);
+    for (auto& point : result.splinePoints)
+        if (!readPoint(input, point))
+            return false;
+
+    // Sections added by newer versions follow here, we don't know them
+    *this = std::move(result);
+    return true;
+}
+
+bool PluginState::read(const void* data, size_t sizeInBytes)
+{
+    if (data == nullptr || sizeInBytes == 0)
+        return false;
+
+    juce::MemoryInputStream input(data, sizeInBytes, false);
+    return read(input);
+}
@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    PluginState.h
+    Created: 17 Oct 2026 7:15:32pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SceneSnapshot.h"
+#include "TrajectoryEngine.h"
+
+// Everything a session or a preset recalls: the parameters by ID, the scene pad and the
+// spline trajectory's points. It's stored as compact binary:
+//
+//   "BRST", version, parameters (ID and plain value), scene, spline points
+//
+// Later versions only ever append sections, so any version can read what it knows of
+// a newer file and skip the rest. Parameters are matched by ID, so adding, removing or
+// reordering them doesn't break old sessions.
+struct PluginState
+{
+    static constexpr juce::uint32 magic = 0x54535242;    // "BRST" little endian
+    static constexpr juce::uint32 currentVersion = 1;
+
+    struct Parameter
+    {
+        juce::String id;
+        float value = 0.0f;     // plain, not normalised, so ranges can change
+    };
+
+    std::vector<Parameter> parameters;
+    SceneSnapshot scene;
+    std::vector<juce::Point<float>> splinePoints;   // empty is the default loop
+
+    void write(juce::OutputStream& output) const;
+
+    // Returns false, leaving the state untouched, if the data isn't a whole state:
+    // wrong magic, cut short, or holding values that aren't finite numbers
+    bool read(juce::InputStream& input);
+    bool read(const void* data, size_t sizeInBytes);
+};
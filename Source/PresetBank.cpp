@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    PresetBank.cpp
+    Created: 17 Oct 2026 7:15:32pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "PresetBank.h"
+
+PresetBank::PresetBank()
+{
+    setDirectory(juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                     .getChildFile("Binaural Rays")
+                     .getChildFile("Presets"));
+}
+
+PresetBank::~PresetBank()
+{
+    // Jobs point back at us, they have to be gone before any member is
+    loader.removeAllJobs(true, 2000);
+    cancelPendingUpdate();
+}
+
+void PresetBank::setDirectory(const juce::File& newDirectory)
+{
+    directory = newDirectory;
+    rescan();
+}
+
+void PresetBank::rescan()
+{
+    presetFiles.clearQuick();
+
+    if (directory.isDirectory())
+        presetFiles = directory.findChildFiles(juce::File::findFiles, false, juce::String("*") + fileExtension);
+
+    std::sort(presetFiles.begin(), presetFiles.end(),
+              [](const juce::File& a, const juce::File& b) { return a.getFileName().compareNatural(b.getFileName()) < 0; });
+}
+
+juce::String PresetBank::getPresetName(int index) const
+{
+    return juce::isPositiveAndBelow(index, presetFiles.size()) ? presetFiles.getReference(index).getFileNameWithoutExtension()
+                                                              : juce::String();
+}
+
+void PresetBank::loadPreset(int index)
+{
+    if (!juce::isPositiveAndBelow(index, presetFiles.size()))
+        return;
+
+    const auto file = presetFiles.getReference(index);
+    const int request = ++latestRequest;
+
+    loader.addJob([this, file, index, request]
+    {
+        // Superseded before we even started
+        if (request != latestRequest.load())
+            return;
+
+        juce::MemoryBlock data;
+        if (!file.loadFileAsData(data))
+            return;
+
+        auto loaded = std::make_unique<LoadedPreset>();
+        loaded->index = index;
+
+        if (!loaded->state.read(data.getData(), data.getSize()))
+            return;
+
+        TrajectoryEngine::buildSpline(loaded->state.splinePoints.data(), (int)loaded->state.splinePoints.size(), loaded->splinePath);
+
+        {
+            const juce::ScopedLock sl(resultLock);
+            result = std::move(loaded);
+            resultRequest = request;
+        }
+
+        triggerAsyncUpdate();
+    });
+}
+
+int PresetBank::savePreset(const juce::String& name, const PluginState& state)
+{
+    if (!directory.createDirectory())
+        return -1;
+
+    const auto file = directory.getChildFile(juce::File::createLegalFileName(name) + fileExtension);
+    juce::MemoryOutputStream output;
+    state.write(output);
+
+    if (!file.replaceWithData(output.getData(), output.getDataSize()))
+        return -1;
+
+    rescan();
+    return presetFiles.indexOf(file);
+}
+
+void PresetBank::handleAsyncUpdate()
+{
+    std::unique_ptr<LoadedPreset> loaded;
+
+    {
+        const juce::ScopedLock sl(resultLock);
+        if (resultRequest != latestRequest.load())
+            return;
+
+        loaded = std::move(result);
+    }
+
+    if (loaded != nullptr && onPresetLoaded != nullptr)
+        onPresetLoaded(*loaded);
+}
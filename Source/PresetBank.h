@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    PresetBank.h
+    Created: 17 Oct 2026 7:15:32pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginState.h"
+#include "TrajectoryEngine.h"
+
+// The .brpreset files (PluginState, same format as the session state) in one folder.
+// Loading one reads and parses the file and builds its spline table on a background
+// thread; onPresetLoaded then gets the result on the message thread, ready to be handed
+// to the audio thread as whole objects. Nothing about a preset switch happens on, or
+// waits for, the audio thread.
+class PresetBank : private juce::AsyncUpdater
+{
+public:
+    static constexpr const char* fileExtension = ".brpreset";
+
+    // A preset with its DSP resources built, waiting to be applied
+    struct LoadedPreset
+    {
+        int index = -1;
+        PluginState state;
+        TrajectoryEngine::Path splinePath;
+    };
+
+    PresetBank();
+    ~PresetBank() override;
+
+    // Message thread. Picks up every preset in the folder, in name order.
+    void setDirectory(const juce::File& newDirectory);
+    const juce::File& getDirectory() const noexcept { return directory; }
+    void rescan();
+
+    int getNumPresets() const noexcept { return presetFiles.size(); }
+    juce::String getPresetName(int index) const;
+
+    // Message thread. Starts loading in the background, a later request supersedes
+    // one that hasn't finished yet.
+    void loadPreset(int index);
+
+    // Message thread. Writes the state as <name>.brpreset and rescans, returns its index.
+    int savePreset(const juce::String& name, const PluginState& state);
+
+    std::function<void(const LoadedPreset&)> onPresetLoaded;
+
+private:
+    void handleAsyncUpdate() override;
+
+    juce::File directory;
+    juce::Array<juce::File> presetFiles;
+
+    juce::ThreadPool loader { 1 };
+    std::atomic<int> latestRequest { 0 };
+
+    juce::CriticalSection resultLock;
+    std::unique_ptr<LoadedPreset> result;   // the finished load, guarded by resultLock
+    int resultRequest = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetBank)
+};
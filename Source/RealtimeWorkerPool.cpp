@@ -0,0 +1,197 @@
+/*
+  ==============================================================================
+
+    RealtimeWorkerPool.cpp
+    Created: 18 Oct 2026 12:31:09am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "RealtimeWorkerPool.h"
+#include "AudioThreadGuard.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+namespace
+{
+    // How long an idle worker polls before it sleeps, longer than the gap between two
+    // blocks at any sensible buffer size, whatever the core's speed or load
+    constexpr double spinSecondsBeforeSleep = 0.003;
+    constexpr int spinsBeforeYield = 64;
+
+    inline void pause() noexcept
+    {
+       #if JUCE_INTEL
+        _mm_pause();
+       #elif JUCE_ARM && (JUCE_MAC || JUCE_IOS || JUCE_LINUX || JUCE_ANDROID)
+        __asm__ __volatile__ ("yield");
+       #endif
+    }
+}
+
+class RealtimeWorkerPool::Worker : public juce::Thread
+{
+public:
+    Worker(RealtimeWorkerPool& ownerPool, int index)
+        : juce::Thread("Voice worker " + juce::String(index)), owner(ownerPool), workerIndex(index)
+    {
+    }
+
+    ~Worker() override
+    {
+        signalThreadShouldExit();
+        wakeUp.signal();
+        stopThread(1000);
+    }
+
+    // Called for every run(), only does anything if the worker has gone to sleep
+    void wakeIfSleeping() noexcept
+    {
+        if (sleeping.load(std::memory_order_seq_cst))
+            wakeUp.signal();
+    }
+
+    void run() override
+    {
+        // No affinity: every plugin instance has its own pool, and pinning them would
+        // stack all of their workers onto the same few cores
+        const auto spinTicks = juce::Time::secondsToHighResolutionTicks(spinSecondsBeforeSleep);
+        auto seen = owner.generation.load(std::memory_order_acquire);
+
+        while (!threadShouldExit())
+        {
+            auto current = owner.generation.load(std::memory_order_acquire);
+            const auto spinDeadline = juce::Time::getHighResolutionTicks() + spinTicks;
+
+            for (int spins = 0; current == seen && !threadShouldExit(); ++spins)
+            {
+                if (spins < spinsBeforeYield)
+                {
+                    pause();
+                }
+                else
+                {
+                    if (juce::Time::getHighResolutionTicks() >= spinDeadline)
+                        break;
+
+                    juce::Thread::yield();
+                }
+
+                current = owner.generation.load(std::memory_order_acquire);
+            }
+
+            if (current == seen)
+            {
+                // Announce the sleep before the last look, a run() published after it
+                // is guaranteed to see the flag and signal
+                sleeping.store(true, std::memory_order_seq_cst);
+                current = owner.generation.load(std::memory_order_seq_cst);
+
+                if (current == seen)
+                    wakeUp.wait(100.0);
+
+                sleeping.store(false, std::memory_order_release);
+                continue;
+            }
+
+            seen = current;
+
+            // Jobs are audio thread work, the same rules apply
+            AudioThreadGuard::ScopedGuard realtimeGuard;
+            owner.work(current, workerIndex);
+        }
+    }
+
+private:
+    RealtimeWorkerPool& owner;
+    const int workerIndex;
+    std::atomic<bool> sleeping { false };
+    juce::WaitableEvent wakeUp;
+};
+
+RealtimeWorkerPool::RealtimeWorkerPool() = default;
+
+RealtimeWorkerPool::~RealtimeWorkerPool()
+{
+    workers.clear();
+}
+
+void RealtimeWorkerPool::setNumThreads(int numThreads)
+{
+    numThreads = juce::jlimit(1, maxThreads, numThreads);
+    if (numThreads == getNumThreads())
+        return;
+
+    workers.clear();
+
+    for (int i = 1; i < numThreads; ++i)
+    {
+        auto* worker = workers.add(new Worker(*this, i));
+
+        // Falls back to a normal high priority thread where realtime isn't allowed
+        if (!worker->startRealtimeThread(juce::Thread::RealtimeOptions{}.withPriority(9)))
+            worker->startThread(juce::Thread::Priority::highest);
+    }
+}
+
+void RealtimeWorkerPool::run(int jobsToRun, Job job, void* context) noexcept
+{
+    if (jobsToRun <= 0)
+        return;
+
+    if (workers.isEmpty() || jobsToRun == 1)
+    {
+        for (int i = 0; i < jobsToRun; ++i)
+            job(context, i, 0);
+
+        return;
+    }
+
+    currentJob = job;
+    currentContext = context;
+    numJobs = jobsToRun;
+    pending.store(jobsToRun, std::memory_order_relaxed);
+
+    const auto newGeneration = generation.load(std::memory_order_relaxed) + 1;
+    claims.store((juce::uint64)newGeneration << 32, std::memory_order_relaxed);
+    generation.store(newGeneration, std::memory_order_seq_cst);
+
+    for (auto* worker : workers)
+        worker->wakeIfSleeping();
+
+    work(newGeneration, 0);
+
+    // Spin barrier, the workers are already busy with the last few jobs
+    for (int spins = 0; pending.load(std::memory_order_acquire) > 0; ++spins)
+    {
+        if (spins < spinsBeforeYield)
+            pause();
+        else
+            juce::Thread::yield();
+    }
+}
+
+void RealtimeWorkerPool::work(juce::uint32 runGeneration, int workerIndex) noexcept
+{
+    for (;;)
+    {
+        auto claim = claims.load(std::memory_order_acquire);
+
+        if ((juce::uint32)(claim >> 32) != runGeneration)
+            return;
+
+        const int jobIndex = (int)(claim & 0xffffffffu);
+        if (jobIndex >= numJobs)
+            return;
+
+        if (!claims.compare_exchange_weak(claim, claim + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+            continue;
+
+        // The run can't finish, and nothing can be overwritten, until this job is done
+        currentJob(currentContext, jobIndex, workerIndex);
+        pending.fetch_sub(1, std::memory_order_release);
+    }
+}
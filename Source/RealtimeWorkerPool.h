@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    RealtimeWorkerPool.h
+    Created: 18 Oct 2026 12:31:09am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Helpers for the audio thread: run() hands out numJobs jobs to the pool's realtime
+// threads and works on them itself, and returns once every one has finished. Nothing on
+// that path locks or allocates: jobs are claimed with a compare-and-swap on one atomic,
+// and the caller waits for the last one on a spin barrier.
+//
+// Each worker spins for a few milliseconds after its last job, so a steady stream of
+// blocks never puts it to sleep. An idle one does sleep, and the next
+// run() wakes it, which is the only time it touches an event, and so the only time
+// run() can take a lock.
+//
+// Which worker runs which job varies from run to run; callers that need the same result
+// whatever the thread count give each job its own output and combine them in job order.
+class RealtimeWorkerPool
+{
+public:
+    using Job = void (*)(void* context, int jobIndex, int workerIndex);
+
+    static constexpr int maxThreads = 16;
+
+    RealtimeWorkerPool();
+    ~RealtimeWorkerPool();
+
+    // Message thread, never while run() may be called. numThreads counts the caller, so
+    // 1 has no workers and run() just loops over the jobs.
+    void setNumThreads(int numThreads);
+    int getNumThreads() const noexcept { return (int)workers.size() + 1; }
+
+    // Calls job(context, jobIndex, workerIndex) for every jobIndex in [0, numJobs).
+    // workerIndex is below getNumThreads(), 0 being the calling thread, and no two jobs
+    // run on the same worker at once.
+    void run(int numJobs, Job job, void* context) noexcept;
+
+    // Same with any callable taking (jobIndex, workerIndex)
+    template <typename Function>
+    void run(int numJobs, Function& function) noexcept
+    {
+        run(numJobs, [](void* context, int jobIndex, int workerIndex) { (*static_cast<Function*>(context))(jobIndex, workerIndex); }, &function);
+    }
+
+private:
+    class Worker;
+
+    // Claims and runs jobs of the given run until there are none left
+    void work(juce::uint32 generation, int workerIndex) noexcept;
+
+    juce::OwnedArray<Worker> workers;
+
+    // Run number in the top half, next unclaimed job in the bottom half, so a worker
+    // still finishing with one run can never claim a job of the next
+    std::atomic<juce::uint64> claims { 0 };
+    std::atomic<juce::uint32> generation { 0 };
+    std::atomic<int> pending { 0 };
+
+    // Written before generation is released, read after it is acquired
+    Job currentJob = nullptr;
+    void* currentContext = nullptr;
+    int numJobs = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(RealtimeWorkerPool)
+};
@@ -0,0 +1,170 @@
+/*
+  ==============================================================================
+
+    ScenePad.cpp
+    Created: 17 Oct 2026 4:02:18pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "ScenePad.h"
+
+void ScenePad::setScene(const SceneSnapshot& newScene)
+{
+    scene = newScene;
+    scene.numSources = juce::jlimit(1, SceneSnapshot::maxSources, scene.numSources);
+    repaint();
+}
+
+juce::Rectangle<float> ScenePad::getPadArea() const
+{
+    return getLocalBounds().toFloat().reduced(sourceRadius);
+}
+
+juce::Point<float> ScenePad::toScreen(juce::Point<float> position) const
+{
+    // +y is in front of the listener, which is up on screen
+    const auto area = getPadArea();
+    const float range = SceneSnapshot::maxCoordinate - SceneSnapshot::minCoordinate;
+
+    return { area.getX() + (position.x - SceneSnapshot::minCoordinate) / range * area.getWidth(),
+             area.getBottom() - (position.y - SceneSnapshot::minCoordinate) / range * area.getHeight() };
+}
+
+juce::Point<float> ScenePad::toScene(juce::Point<float> screenPosition) const
+{
+    const auto area = getPadArea();
+    const float range = SceneSnapshot::maxCoordinate - SceneSnapshot::minCoordinate;
+
+    if (area.getWidth() <= 0.0f || area.getHeight() <= 0.0f)
+        return { 50.0f, 50.0f };
+
+    const float x = SceneSnapshot::minCoordinate + (screenPosition.x - area.getX()) / area.getWidth() * range;
+    const float y = SceneSnapshot::minCoordinate + (area.getBottom() - screenPosition.y) / area.getHeight() * range;
+
+    return { juce::jlimit(SceneSnapshot::minCoordinate, SceneSnapshot::maxCoordinate, x),
+             juce::jlimit(SceneSnapshot::minCoordinate, SceneSnapshot::maxCoordinate, y) };
+}
+
+int ScenePad::findSourceAt(juce::Point<float> screenPosition) const
+{
+    // Topmost first, that's the one drawn last
+    for (int s = scene.numSources; --s >= 0;)
+        if (toScreen(scene.positions[(size_t)s]).getDistanceFrom(screenPosition) <= sourceRadius * 1.5f)
+            return s;
+
+    return -1;
+}
+
+void ScenePad::sendScene()
+{
+    repaint();
+
+    if (onSceneChanged != nullptr)
+        onSceneChanged(scene);
+}
+
+void ScenePad::paint(juce::Graphics& g)
+{
+    const auto area = getPadArea();
+
+    g.setColour(juce::Colours::black);
+    g.fillRect(area);
+    g.setColour(juce::Colours::grey);
+    g.drawRect(area, 1.0f);
+
+    // The listener, with the ears where SpatialVoiceState puts them
+    const auto head = toScreen({ 50.0f, 50.0f });
+    const auto leftEar = toScreen({ 30.0f, 50.0f });
+    const float headRadius = head.getDistanceFrom(leftEar);
+
+    g.setColour(juce::Colours::lightgrey);
+    g.drawEllipse(head.x - headRadius, head.y - headRadius, headRadius * 2.0f, headRadius * 2.0f, 1.5f);
+    g.drawLine(head.x, head.y - headRadius, head.x, head.y - headRadius * 1.3f, 1.5f);
+
+    for (int s = 0; s < scene.numSources; ++s)
+    {
+        const auto centre = toScreen(scene.positions[(size_t)s]);
+        const juce::Rectangle<float> dot(centre.x - sourceRadius, centre.y - sourceRadius, sourceRadius * 2.0f, sourceRadius * 2.0f);
+
+        g.setColour(s == draggedSource || draggingAll ? juce::Colours::yellow : juce::Colours::orange);
+        g.fillEllipse(dot.getX(), dot.getY(), dot.getWidth(), dot.getHeight());
+        g.setColour(juce::Colours::black);
+        g.setFont(11.0f);
+        g.drawText(juce::String(s + 1), dot, juce::Justification::centred, false);
+    }
+}
+
+void ScenePad::mouseDown(const juce::MouseEvent& e)
+{
+    draggedSource = findSourceAt(e.position);
+    draggingAll = draggedSource >= 0 && e.mods.isShiftDown();
+    sceneAtDragStart = scene;
+    dragStart = toScene(e.position);
+    repaint();
+}
+
+void ScenePad::mouseDrag(const juce::MouseEvent& e)
+{
+    if (draggedSource < 0)
+        return;
+
+    const auto position = toScene(e.position);
+
+    if (!draggingAll)
+    {
+        scene.positions[(size_t)draggedSource] = position;
+        sendScene();
+        return;
+    }
+
+    // The whole scene moves by the same offset, stopping where its first source hits a wall
+    auto offset = position - dragStart;
+
+    for (int s = 0; s < scene.numSources; ++s)
+    {
+        const auto& start = sceneAtDragStart.positions[(size_t)s];
+        offset.x = juce::jlimit(SceneSnapshot::minCoordinate - start.x, SceneSnapshot::maxCoordinate - start.x, offset.x);
+        offset.y = juce::jlimit(SceneSnapshot::minCoordinate - start.y, SceneSnapshot::maxCoordinate - start.y, offset.y);
+    }
+
+    for (int s = 0; s < scene.numSources; ++s)
+        scene.positions[(size_t)s] = sceneAtDragStart.positions[(size_t)s] + offset;
+
+    sendScene();
+}
+
+void ScenePad::mouseUp(const juce::MouseEvent&)
+{
+    draggedSource = -1;
+    draggingAll = false;
+    repaint();
+}
+
+void ScenePad::mouseDoubleClick(const juce::MouseEvent& e)
+{
+    const int source = findSourceAt(e.position);
+
+    if (source < 0)
+    {
+        if (scene.numSources == SceneSnapshot::maxSources)
+            return;
+
+        scene.positions[(size_t)scene.numSources++] = toScene(e.position);
+    }
+    else
+    {
+        // There's always at least one source
+        if (scene.numSources == 1)
+            return;
+
+        for (int s = source; s < scene.numSources - 1; ++s)
+            scene.positions[(size_t)s] = scene.positions[(size_t)s + 1];
+
+        --scene.numSources;
+    }
+
+    draggedSource = -1;
+    sendScene();
+}
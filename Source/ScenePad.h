@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    ScenePad.h
+    Created: 17 Oct 2026 4:02:18pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SceneSnapshot.h"
+
+// Top view of the box with the listener's head in the middle and every source of the
+// scene as a numbered dot. Drag a dot to move it, shift-drag to move the whole scene
+// together, double-click empty space to add a source and double-click a dot to remove it.
+// Each change goes out as one whole scene through onSceneChanged.
+class ScenePad : public juce::Component
+{
+public:
+    ScenePad() = default;
+
+    void setScene(const SceneSnapshot& newScene);
+    const SceneSnapshot& getScene() const noexcept { return scene; }
+
+    std::function<void(const SceneSnapshot&)> onSceneChanged;
+
+    void paint(juce::Graphics& g) override;
+    void mouseDown(const juce::MouseEvent& e) override;
+    void mouseDrag(const juce::MouseEvent& e) override;
+    void mouseUp(const juce::MouseEvent& e) override;
+    void mouseDoubleClick(const juce::MouseEvent& e) override;
+
+private:
+    static constexpr float sourceRadius = 8.0f;
+
+    juce::Rectangle<float> getPadArea() const;
+    juce::Point<float> toScreen(juce::Point<float> position) const;
+    juce::Point<float> toScene(juce::Point<float> screenPosition) const;
+    int findSourceAt(juce::Point<float> screenPosition) const;
+    void sendScene();
+
+    SceneSnapshot scene;
+    SceneSnapshot sceneAtDragStart;
+    juce::Point<float> dragStart;
+    int draggedSource = -1;
+    bool draggingAll = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScenePad)
+};
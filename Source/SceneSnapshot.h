@@ -0,0 +1,38 @@
+/*
+  ==============================================================================
+
+    SceneSnapshot.h
+    Created: 17 Oct 2026 4:02:18pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Where every source of the scene pad is, in the same 1 to 100 box coordinates as
+// the X/Y parameters. It's a plain fixed size value so whole scenes can go through a
+// TripleBuffer to the audio thread without allocating. Voice v plays from source
+// v % numSources, so a single source behaves like the X/Y sliders.
+struct SceneSnapshot
+{
+    static constexpr int maxSources = 16;
+    static constexpr float minCoordinate = 1.0f;
+    static constexpr float maxCoordinate = 100.0f;
+
+    int numSources = 1;
+    std::array<juce::Point<float>, maxSources> positions;
+
+    SceneSnapshot()
+    {
+        positions.fill({ 50.0f, 50.0f });
+    }
+
+    const juce::Point<float>& getSourceForVoice(int voiceIndex) const noexcept
+    {
+        jassert(numSources > 0 && numSources <= maxSources);
+        return positions[(size_t)(voiceIndex % numSources)];
+    }
+};
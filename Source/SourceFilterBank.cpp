@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+    SourceFilterBank.cpp
+    Created: 17 Oct 2026 9:02:40pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "SourceFilterBank.h"
+
+namespace
+{
+    // Treble loss through air, roughly what 10 kHz loses at room temperature and humidity
+    constexpr double airCornerHz = 8000.0;
+    constexpr double airDbPerMeter = 0.1;
+
+    // Fully behind the head the far ear loses this much, from a much lower corner
+    constexpr double shadowCornerHz = 1500.0;
+    constexpr double maxShadowDb = 12.0;
+
+    constexpr uintptr_t alignment = (uintptr_t)SourceFilterBank::Vec::SIMDRegisterSize;
+
+    float* alignUp(float* pointer) noexcept
+    {
+        const auto address = reinterpret_cast<uintptr_t>(pointer);
+        return reinterpret_cast<float*>((address + alignment - 1) & ~(alignment - 1));
+    }
+}
+
+void SourceFilterBank::prepare(double sampleRate, int numSourcesToUse, int maxBlockSize)
+{
+    // Every shelf is designed once here, process() only interpolates between them
+    table.resize((size_t)(distanceBins * angleBins));
+
+    for (int d = 0; d < distanceBins; ++d)
+    {
+        const double meters = maxTableDistance * d / (distanceBins - 1);
+
+        for (int a = 0; a < angleBins; ++a)
+        {
+            const double angle = juce::MathConstants<double>::pi * a / (angleBins - 1);
+            const double shadow = 0.5 * (1.0 - std::cos(angle));
+
+            const double corner = juce::jmin(airCornerHz * std::pow(shadowCornerHz / airCornerHz, shadow), 0.45 * sampleRate);
+            const double gainDb = -airDbPerMeter * meters - maxShadowDb * shadow;
+
+            table[(size_t)(d * angleBins + a)] = makeHighShelf(sampleRate, corner, gainDb);
+        }
+    }
+
+    numSources = numSourcesToUse;
+    stride = (numSources + lanes - 1) / lanes * lanes;
+    stateStorage.allocate((size_t)(2 * numStateArrays * stride + lanes), true);
+
+    auto* array = alignUp(stateStorage.get());
+    for (auto& ear : state)
+    {
+        for (auto*& values : ear)
+        {
+            values = array;
+            array += stride;
+        }
+    }
+
+    maxSamples = maxBlockSize;
+
+    // Flat until the first setSource()
+    for (auto& ear : state)
+        std::fill(ear[b0], ear[b0] + stride, 1.0f);
+
+    reset();
+}
+
+void SourceFilterBank::reset() noexcept
+{
+    for (auto& ear : state)
+    {
+        if (ear[z1] == nullptr)
+            continue;
+
+        std::fill(ear[z1], ear[z1] + stride, 0.0f);
+        std::fill(ear[z2], ear[z2] + stride, 0.0f);
+    }
+}
+
+SourceFilterBank::Coefficients SourceFilterBank::makeHighShelf(double sampleRate, double frequency, double gainDb) noexcept
+{
+    // RBJ cookbook shelf with a slope of one
+    const double A = std::pow(10.0, gainDb / 40.0);
+    const double w0 = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+    const double cosW = std::cos(w0);
+    const double alpha = std::sin(w0) / std::sqrt(2.0);
+    const double twoRootAAlpha = 2.0 * std::sqrt(A) * alpha;
+
+    const double a0 = (A + 1.0) - (A - 1.0) * cosW + twoRootAAlpha;
+
+    Coefficients c;
+    c.b0 = (float)(A * ((A + 1.0) + (A - 1.0) * cosW + twoRootAAlpha) / a0);
+    c.b1 = (float)(-2.0 * A * ((A - 1.0) + (A + 1.0) * cosW) / a0);
+    c.b2 = (float)(A * ((A + 1.0) + (A - 1.0) * cosW - twoRootAAlpha) / a0);
+    c.a1 = (float)(2.0 * ((A - 1.0) - (A + 1.0) * cosW) / a0);
+    c.a2 = (float)(((A + 1.0) - (A - 1.0) * cosW - twoRootAAlpha) / a0);
+    return c;
+}
+
+SourceFilterBank::Coefficients SourceFilterBank::lookUp(float meters, float angle) const noexcept
+{
+    const float d = juce::jlimit(0.0f, (float)(distanceBins - 1), meters / maxTableDistance * (float)(distanceBins - 1));
+    const float a = juce::jlimit(0.0f, (float)(angleBins - 1), angle / juce::MathConstants<float>::pi * (float)(angleBins - 1));
+
+    const int d0 = juce::jmin((int)d, distanceBins - 2);
+    const int a0 = juce::jmin((int)a, angleBins - 2);
+    const float fd = d - (float)d0, fa = a - (float)a0;
+
+    // Neighbouring shelves are close enough for their coefficients to blend
+    const auto& c00 = table[(size_t)(d0 * angleBins + a0)];
+    const auto& c01 = table[(size_t)(d0 * angleBins + a0 + 1)];
+    const auto& c10 = table[(size_t)((d0 + 1) * angleBins + a0)];
+    const auto& c11 = table[(size_t)((d0 + 1) * angleBins + a0 + 1)];
+
+    auto blend = [fd, fa](float v00, float v01, float v10, float v11)
+    {
+        const float near = v00 + fa * (v01 - v00);
+        const float far = v10 + fa * (v11 - v10);
+        return near + fd * (far - near);
+    };
+
+    Coefficients c;
+    c.b0 = blend(c00.b0, c01.b0, c10.b0, c11.b0);
+    c.b1 = blend(c00.b1, c01.b1, c10.b1, c11.b1);
+    c.b2 = blend(c00.b2, c01.b2, c10.b2, c11.b2);
+    c.a1 = blend(c00.a1, c01.a1, c10.a1, c11.a1);
+    c.a2 = blend(c00.a2, c01.a2, c10.a2, c11.a2);
+    return c;
+}
+
+void SourceFilterBank::setSource(int source, float metersLeft, float metersRight, float azimuth) noexcept
+{
+    jassert(juce::isPositiveAndBelow(source, numSources));
+
+    // Angle between the source and each ear's axis, the left ear points to -pi/2
+    const float side = std::sin(azimuth);
+    const float angles[] = { shadowEnabled ? std::acos(juce::jlimit(-1.0f, 1.0f, -side)) : 0.0f,
+                             shadowEnabled ? std::acos(juce::jlimit(-1.0f, 1.0f, side)) : 0.0f };
+    const float meters[] = { metersLeft, metersRight };
+
+    for (int ear = 0; ear < 2; ++ear)
+    {
+        const auto c = lookUp(meters[ear], angles[ear]);
+        state[ear][b0][source] = c.b0;
+        state[ear][b1][source] = c.b1;
+        state[ear][b2][source] = c.b2;
+        state[ear][a1][source] = c.a1;
+        state[ear][a2][source] = c.a2;
+    }
+}
+
+void SourceFilterBank::process(int firstSource, float* const* ears, int count, int numSamples, float* interleaved) noexcept
+{
+    jassert(count > 0 && count <= lanes && firstSource % lanes == 0);
+    jassert(numSamples <= maxSamples);
+
+    for (int ear = 0; ear < 2; ++ear)
+    {
+        auto* const* s = state[ear];
+
+        // One frame per sample, one lane per source; missing sources are silent lanes
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto* frame = interleaved + i * lanes;
+
+            for (int l = 0; l < count; ++l)
+                frame[l] = ears[l * 2 + ear][i];
+
+            for (int l = count; l < lanes; ++l)
+                frame[l] = 0.0f;
+        }
+
+        const auto cb0 = Vec::fromRawArray(s[b0] + firstSource);
+        const auto cb1 = Vec::fromRawArray(s[b1] + firstSource);
+        const auto cb2 = Vec::fromRawArray(s[b2] + firstSource);
+        const auto ca1 = Vec::fromRawArray(s[a1] + firstSource);
+        const auto ca2 = Vec::fromRawArray(s[a2] + firstSource);
+        auto state1 = Vec::fromRawArray(s[z1] + firstSource);
+        auto state2 = Vec::fromRawArray(s[z2] + firstSource);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto* frame = interleaved + i * lanes;
+            const auto x = Vec::fromRawArray(frame);
+            const auto y = cb0 * x + state1;
+
+            state1 = cb1 * x - ca1 * y + state2;
+            state2 = cb2 * x - ca2 * y;
+            y.copyToRawArray(frame);
+        }
+
+        state1.copyToRawArray(s[z1] + firstSource);
+        state2.copyToRawArray(s[z2] + firstSource);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto* frame = interleaved + i * lanes;
+
+            for (int l = 0; l < count; ++l)
+                ears[l * 2 + ear][i] = frame[l];
+        }
+    }
+}
@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    SourceFilterBank.h
+    Created: 17 Oct 2026 9:02:40pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Per source, per ear high shelf for air absorption (more treble loss the further the
+// source is from the ear) and head shadowing (more the further round the head it is
+// from that ear). The shelves come from a table of distance and angle built in prepare(),
+// bilinearly interpolated, so nothing trig heavy runs per block.
+//
+// The biquads run a SIMD register of sources at a time: the group's ears are interleaved
+// sample by sample, filtered as one transposed direct form II per lane and split again.
+class SourceFilterBank
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int lanes = (int)Vec::size();
+
+    static constexpr int distanceBins = 64;
+    static constexpr int angleBins = 32;
+    static constexpr float maxTableDistance = 20.0f;    // meters, further away uses the last bin
+
+    void prepare(double sampleRate, int numSources, int maxBlockSize);
+    void reset() noexcept;
+
+    // The HRIRs already shadow the far ear, so only the distance part applies while they're on
+    void setShadowEnabled(bool shouldShadow) noexcept { shadowEnabled = shouldShadow; }
+
+    // New shelves for one source, from each ear's distance in meters and the azimuth of
+    // the source around the head (0 in front, positive to the right). They take over at
+    // the next process().
+    void setSource(int source, float metersLeft, float metersRight, float azimuth) noexcept;
+
+    // Filters both ears of sources [firstSource, firstSource + count) in place, count is at
+    // most lanes. ears holds lanes pairs of pointers, left then right for each source.
+    // scratch is SIMD aligned and getScratchSize() long; different registers of sources
+    // can be filtered on different threads at once, each with its own.
+    void process(int firstSource, float* const* ears, int count, int numSamples, float* scratch) noexcept;
+    static int getScratchSize(int maxBlockSize) noexcept { return maxBlockSize * lanes; }
+
+private:
+    struct Coefficients
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    };
+
+    static Coefficients makeHighShelf(double sampleRate, double frequency, double gainDb) noexcept;
+    Coefficients lookUp(float meters, float angle) const noexcept;
+
+    std::vector<Coefficients> table;    // distance major, then angle
+    bool shadowEnabled = true;
+
+    // Per ear and source: b0, b1, b2, a1, a2, z1, z2, each padded to whole registers
+    enum { b0, b1, b2, a1, a2, z1, z2, numStateArrays };
+    juce::HeapBlock<float> stateStorage;
+    float* state[2][numStateArrays] = {};
+    int numSources = 0;
+    int stride = 0;
+
+    int maxSamples = 0;
+};
@@ -0,0 +1,866 @@
+/*
+  ==============================================================================
+
+    SpatialVoiceState.cpp
+    Created: 17 Oct 2026 10:12:03am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "SpatialVoiceState.h"
+
+namespace
+{
+    using Vec = juce::dsp::SIMDRegister<float>;
+    constexpr int lanes = (int)Vec::size();
+    constexpr uintptr_t cacheLine = DelayArena::alignment;
+    constexpr int floatsPerCacheLine = (int)(cacheLine / sizeof(float));
+}
+
+SpatialVoiceState::SpatialVoiceState(int numVoicesToUse)
+    : numVoices(juce::jlimit(minVoices, maxVoices, numVoicesToUse)),
+      trajectories(numVoices)
+{
+    // Whole cache lines per array, which is also whole SIMD registers
+    constexpr int numArrays = 11;
+    soaStride = (numVoices + floatsPerCacheLine - 1) / floatsPerCacheLine * floatsPerCacheLine;
+    soaStorage.allocate((size_t)(numArrays * soaStride + floatsPerCacheLine), true);
+
+    const auto address = reinterpret_cast<uintptr_t>(soaStorage.get());
+    auto* arrays = reinterpret_cast<float*>((address + cacheLine - 1) & ~(cacheLine - 1));
+
+    for (auto* array : { &posX, &posY, &distanceL, &distanceR, &delayL, &delayR, &gainL, &gainR, &azimuth, &elevation, &filterAzimuth })
+    {
+        *array = arrays;
+        arrays += soaStride;
+    }
+
+    std::fill(posX, posX + soaStride, nextX);
+    std::fill(posY, posY + soaStride, nextY);
+    std::fill(gainL, gainL + soaStride, 1.0f);
+    std::fill(gainR, gainR + soaStride, 1.0f);
+
+    headL.resize(numVoices);
+    headR.resize(numVoices);
+    geometryDirty.assign(numVoices, 1);
+    soundingVoices.assign(numVoices, 0);
+    awakeVoices.assign(numVoices, 0);
+    silentSamples.assign(numVoices, 0);
+
+    // The audio thread's own, there's always one
+    contexts.add(new RenderContext());
+}
+
+
+void SpatialVoiceState::prepare(double sampleRate, int samplesPerBlock, float maxDimension)
+{
+    // Voices render at the host rate, everything else runs at the internal one
+    voiceBuffers.setSize(numVoices, samplesPerBlock);
+    sendBuffer.setSize(1, samplesPerBlock);
+    hostSampleRate = sampleRate;
+
+    const int factor = 1 << oversamplingLog2;
+    internalBlockSize = samplesPerBlock * factor;
+    currentSampleRate = getInternalSampleRate(sampleRate, oversamplingLog2);
+
+    if (oversamplingLog2 > 0)
+    {
+        const auto filter = oversamplingLinearPhase ? juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple
+                                                    : juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR;
+
+        voiceOversampler = std::make_unique<juce::dsp::Oversampling<float>>((size_t)numVoices, (size_t)oversamplingLog2, filter, true, true);
+        mixOversampler = std::make_unique<juce::dsp::Oversampling<float>>((size_t)2, (size_t)oversamplingLog2, filter, true, true);
+        voiceOversampler->initProcessing((size_t)samplesPerBlock);
+        mixOversampler->initProcessing((size_t)samplesPerBlock);
+
+        oversampledVoices.assign((size_t)numVoices, nullptr);
+        mixBuffer.setSize(2, samplesPerBlock);
+    }
+    else
+    {
+        voiceOversampler.reset();
+        mixOversampler.reset();
+        oversampledVoices.clear();
+        mixBuffer.setSize(0, 0);
+    }
+
+    hrtfPartitionSize = HrtfSet::getPartitionSize(currentSampleRate);
+
+    // No ear is ever further away than the side of the box, so that bounds the direct delay.
+    // Reflections come from further, and wait for the HRIRs' latency on top.
+    // The ring also holds a whole block (written before it is read) and the interpolator taps.
+    float maxPath = maxDimension;
+    if (reflections.getOrder() > 0)
+        maxPath = juce::jmax(maxPath, reflections.getMaxPathLength(maxDistance) * maxDimension / maxDistanceToEar);
+
+    const int maxDelaySamples = (int)std::ceil(maxPath / speedOfSound * currentSampleRate) + hrtfPartitionSize + 8;
+    delaySize = juce::nextPowerOfTwo(maxDelaySamples + internalBlockSize);
+
+    reflections.prepare(numVoices);
+
+    delays.allocate(numVoices, delaySize);
+    delaySize = delays.getRingSize();
+
+    hrtf.prepare(currentSampleRate, hrtfPartitionSize, HrtfSet::headPartitions, hrtfDatabase);
+    filters.prepare(currentSampleRate, numVoices, internalBlockSize);
+    filters.setShadowEnabled(!hrtfEnabled);
+
+    trajectories.prepare(currentSampleRate, internalBlockSize);
+
+    // Scratch for every thread that renders voices. The per sample ear geometry and
+    // positions for the trajectories each get their own cache line.
+    const int numContexts = workerPool != nullptr ? workerPool->getNumThreads() : 1;
+    const int pathStride = (internalBlockSize + floatsPerCacheLine - 1) / floatsPerCacheLine * floatsPerCacheLine;
+    const int filterStride = (SourceFilterBank::getScratchSize(internalBlockSize) + floatsPerCacheLine - 1) / floatsPerCacheLine * floatsPerCacheLine;
+
+    while (contexts.size() < numContexts)
+        contexts.add(new RenderContext());
+
+    contexts.removeRange(numContexts, contexts.size() - numContexts);
+
+    for (auto* context : contexts)
+    {
+        context->itd.setInterpolation(currentInterpolation);
+        context->itd.prepare(internalBlockSize);
+        context->reflectionReader.setInterpolation(ItdDelayEngine::Interpolation::linear);
+        context->reflectionReader.prepare(internalBlockSize);
+        context->earBuffer.setSize(2 * lanes, internalBlockSize);
+        context->storage.allocate((size_t)(8 * pathStride + filterStride + floatsPerCacheLine), true);
+
+        const auto address = reinterpret_cast<uintptr_t>(context->storage.get());
+        auto* array = reinterpret_cast<float*>((address + cacheLine - 1) & ~(cacheLine - 1));
+
+        for (auto** path : { &context->pathArrays[0], &context->pathArrays[1], &context->pathArrays[2], &context->pathArrays[3],
+                             &context->pathArrays[4], &context->pathArrays[5], &context->pathX, &context->pathY })
+        {
+            *path = array;
+            array += pathStride;
+        }
+
+        context->filterScratch = array;
+    }
+
+    numChunks = (numVoices + voicesPerChunk - 1) / voicesPerChunk;
+    chunkMixes.setSize(2 * numChunks, internalBlockSize);
+
+    hrtfFilterSize = hrtf.getFilterSize();
+    if (hrtf.isInterpolated())
+        hrtfStorage.allocate((size_t)(numVoices * 2 * hrtfSlotsPerEar * hrtfFilterSize), true);
+    else
+        hrtfStorage.free();
+
+    // The model's responses fit in the head, measured ones may need a tail
+    const int tailPartitions = hrtf.isInterpolated() ? (int)hrtfDatabase->getHeader().numTailPartitions : 0;
+
+    if (convolvers.isEmpty())
+        for (int v = 0; v < numVoices; ++v)
+            convolvers.add(new PartitionedConvolver());
+
+    for (auto* convolver : convolvers)
+        convolver->prepare(hrtfPartitionSize, HrtfSet::headPartitions, tailPartitions, 2);
+
+    // The partition is the same length in time whatever the rate, so at the host rate it's
+    // hrtfPartitionSize / factor. With integer latency the oversamplers report whole samples.
+    latencySamples = hrtfPartitionSize / factor;
+    if (voiceOversampler != nullptr)
+        latencySamples += (int)voiceOversampler->getLatencyInSamples();
+
+    // A silent voice has nothing left to play once every sample in its ring has been
+    // overwritten and the last of them has made it through the HRIRs and both oversamplers.
+    // Until then its ring still has to be written, as a sleeping voice's isn't.
+    const int responseLength = hrtfPartitionSize * (HrtfSet::headPartitions + 1)
+                             + tailPartitions * (hrtfPartitionSize * HrtfSet::headPartitions);
+    responseSeconds = responseLength / currentSampleRate;
+    drainSamples = (delaySize + responseLength + 2 * internalBlockSize) / factor + 2 * latencySamples + samplesPerBlock;
+
+    reverb.prepare(sampleRate, samplesPerBlock, maxDimension,
+                   latencySamples + (int)std::ceil(maxDimension / speedOfSound * sampleRate));
+    updateReverbRoom();
+
+    ambisonics.prepare(numVoices, ambisonicOrder, samplesPerBlock, latencySamples);
+
+    // The same length in time as the voices' own rings, so it holds the longest direct delay
+    ambisonicDelays.allocate(ambisonicOrder > 0 ? numVoices : 0, delaySize / factor);
+    ambisonicReader.prepare(samplesPerBlock);
+    ambisonicHeads.assign((size_t)numVoices, {});
+    ambisonicInput.setSize(1, samplesPerBlock);
+
+    reset();
+}
+
+void SpatialVoiceState::setOversampling(int factorLog2, bool linearPhase) noexcept
+{
+    oversamplingLog2 = juce::jlimit(0, 3, factorLog2);
+    oversamplingLinearPhase = linearPhase;
+}
+
+void SpatialVoiceState::reset()
+{
+    voiceBuffers.clear();
+    delays.clear();
+    writePos = 0;
+
+    for (auto* convolver : convolvers)
+        convolver->reset();
+
+    if (voiceOversampler != nullptr)
+    {
+        voiceOversampler->reset();
+        mixOversampler->reset();
+    }
+
+    trajectories.reset();
+    filters.reset();
+    reverb.reset();
+    reverbTailRemaining = 0;
+    ambisonics.reset();
+    ambisonicDelays.clear();
+    ambisonicWritePos = 0;
+    snapHeads = true;
+    std::fill(geometryDirty.begin(), geometryDirty.end(), (juce::uint8)1);
+
+    // Everything is clear, so every voice starts asleep
+    std::fill(soundingVoices.begin(), soundingVoices.end(), (juce::uint8)0);
+    std::fill(awakeVoices.begin(), awakeVoices.end(), (juce::uint8)0);
+    std::fill(silentSamples.begin(), silentSamples.end(), drainSamples);
+    ambisonicSilence = drainSamples;
+    idle = true;
+}
+
+void SpatialVoiceState::setNextNotePosition(float x, float y) noexcept
+{
+    nextX = x;
+    nextY = y;
+    sceneActive = false;
+}
+
+void SpatialVoiceState::assignNotePosition(int voiceIndex) noexcept
+{
+    if (sceneActive)
+    {
+        const auto& source = scene.getSourceForVoice(voiceIndex);
+        setVoicePosition(voiceIndex, source.x, source.y);
+        return;
+    }
+
+    setVoicePosition(voiceIndex, nextX, nextY);
+}
+
+void SpatialVoiceState::applyScene(const SceneSnapshot& newScene) noexcept
+{
+    scene = newScene;
+    scene.numSources = juce::jlimit(1, SceneSnapshot::maxSources, scene.numSources);
+    sceneActive = true;
+
+    // Voices whose source didn't move keep their filters
+    for (int v = 0; v < numVoices; ++v)
+    {
+        const auto& source = scene.getSourceForVoice(v);
+        if (source.x != posX[v] || source.y != posY[v])
+            setVoicePosition(v, source.x, source.y);
+    }
+}
+
+void SpatialVoiceState::setVoicePosition(int voiceIndex, float x, float y) noexcept
+{
+    jassert(juce::isPositiveAndBelow(voiceIndex, numVoices));
+    posX[voiceIndex] = x;
+    posY[voiceIndex] = y;
+    geometryDirty[voiceIndex] = 1;
+}
+
+void SpatialVoiceState::setDimension(float newDimension) noexcept
+{
+    dimension = newDimension;
+    std::fill(geometryDirty.begin(), geometryDirty.end(), (juce::uint8)1);
+    updateReverbRoom();
+}
+
+void SpatialVoiceState::setReflectivity(float reflectivity) noexcept
+{
+    if (!reflections.setReflectivity(reflectivity))
+        return;
+
+    std::fill(geometryDirty.begin(), geometryDirty.end(), (juce::uint8)1);
+    updateReverbRoom();
+}
+
+void SpatialVoiceState::setReverb(float send, int numLines) noexcept
+{
+    reverbSend = send;
+    reverb.setNumLines(numLines);
+}
+
+void SpatialVoiceState::updateReverbRoom() noexcept
+{
+    // The tail comes in about when the first reflections do
+    reverb.setRoom(dimension, reflections.getReflectivity(),
+                   latencySamples + juce::roundToInt(dimension / speedOfSound * hostSampleRate));
+}
+
+double SpatialVoiceState::getTailLengthSeconds(float roomDimension, float reflectivity, bool reverbOn) const noexcept
+{
+    // The direct sound of the furthest source, through its HRIRs
+    double tail = roomDimension / speedOfSound + responseSeconds;
+
+    // The furthest image arrives last
+    if (reflections.getOrder() > 0)
+        tail = juce::jmax(tail, (double)(reflections.getMaxPathLength(maxDistance) * roomDimension / maxDistanceToEar / speedOfSound));
+
+    if (reverbOn)
+        tail = juce::jmax(tail, roomDimension / speedOfSound + LateReverb::getDecayTime(roomDimension, reflectivity));
+
+    return tail;
+}
+
+SpatialVoiceState::EarScale SpatialVoiceState::getEarScale() const noexcept
+{
+    // Normalized distance relative to the maxDistance, from 0 to 100, scaled by maxDistanceToEar.
+    // The interpolator needs a little delay to stay causal, both ears get it so the ITD is unchanged
+    return { dimension / maxDistanceToEar,
+             (float)currentSampleRate / speedOfSound,
+             contexts.getFirst()->itd.getMinimumDelay(),
+             (float)(delaySize - internalBlockSize - 4) };
+}
+
+void SpatialVoiceState::computeEars(const EarScale& scale, const float* x, const float* y, int count,
+                                    float* distL, float* distR, float* dlyL, float* dlyR, float* gnL, float* gnR) const noexcept
+{
+    jassert(count % lanes == 0);
+
+    const auto earLX = Vec::expand(leftEarX), earLY = Vec::expand(leftEarY);
+    const auto earRX = Vec::expand(rightEarX), earRY = Vec::expand(rightEarY);
+    const auto meters = Vec::expand(scale.toMeters);
+    const auto samples = Vec::expand(scale.toSamples);
+    const auto delayFloor = Vec::expand(scale.minDelay), delayCeiling = Vec::expand(scale.maxDelay);
+    const auto one = Vec::expand(1.0f), gainSlope = Vec::expand(1.0f / maxDistance);
+
+    for (int i = 0; i < count; i += lanes)
+    {
+        const auto px = Vec::fromRawArray(x + i);
+        const auto py = Vec::fromRawArray(y + i);
+        const auto dxL = px - earLX, dyL = earLY - py;
+        const auto dxR = px - earRX, dyR = earRY - py;
+
+        (dxL * dxL + dyL * dyL).copyToRawArray(distL + i);
+        (dxR * dxR + dyR * dyR).copyToRawArray(distR + i);
+    }
+
+    // SIMDRegister has no square root, this loop is simple enough for the compiler to vectorise
+    for (int i = 0; i < count; ++i)
+    {
+        distL[i] = std::sqrt(distL[i]);
+        distR[i] = std::sqrt(distR[i]);
+    }
+
+    for (int i = 0; i < count; i += lanes)
+    {
+        // Distance in meters:
+        const auto lDistance = Vec::fromRawArray(distL + i) * meters;
+        const auto rDistance = Vec::fromRawArray(distR + i) * meters;
+
+        Vec::min(delayFloor + lDistance * samples, delayCeiling).copyToRawArray(dlyL + i);
+        Vec::min(delayFloor + rDistance * samples, delayCeiling).copyToRawArray(dlyR + i);
+
+        (one - lDistance * gainSlope).copyToRawArray(gnL + i);
+        (one - rDistance * gainSlope).copyToRawArray(gnR + i);
+    }
+}
+
+void SpatialVoiceState::updateGeometry() noexcept
+{
+    const auto scale = getEarScale();
+
+    // The head sits halfway between the ears, facing +y
+    const float centreX = (leftEarX + rightEarX) * 0.5f;
+    const float centreY = (leftEarY + rightEarY) * 0.5f;
+
+    for (int first = 0; first < numVoices; first += lanes)
+    {
+        const int last = juce::jmin(first + lanes, numVoices);
+        bool anyDirty = false;
+
+        for (int v = first; v < last; ++v)
+            anyDirty = anyDirty || geometryDirty[(size_t)v] != 0;
+
+        // Clean sources in a dirty register just get the same numbers again
+        if (!anyDirty)
+            continue;
+
+        computeEars(scale, posX + first, posY + first, lanes, distanceL + first, distanceR + first,
+                    delayL + first, delayR + first, gainL + first, gainR + first);
+        updateReflections(scale, first, posX + first, posY + first);
+
+        for (int v = first; v < last; ++v)
+        {
+            if (!geometryDirty[(size_t)v])
+                continue;
+
+            geometryDirty[(size_t)v] = 0;
+            azimuth[v] = std::atan2(posX[v] - centreX, posY[v] - centreY);
+            filters.setSource(v, distanceL[v] * scale.toMeters, distanceR[v] * scale.toMeters, azimuth[v]);
+            updateFilters(v);
+        }
+    }
+}
+
+void SpatialVoiceState::updateReflections(const EarScale& scale, int first, const float* x, const float* y) noexcept
+{
+    alignas(Vec::SIMDRegisterSize) float imageX[lanes];
+    alignas(Vec::SIMDRegisterSize) float imageY[lanes];
+
+    // Reflections skip the HRIRs, they're held back by the convolution's latency instead
+    // so that they stay behind the direct sound
+    for (int image = 0; image < reflections.getNumImages(); ++image)
+    {
+        reflections.getImagePositions(image, maxDistance, x, y, lanes, imageX, imageY);
+        computeEars(scale, imageX, imageY, lanes,
+                    reflections.getTaps(image, EarlyReflections::distanceL) + first, reflections.getTaps(image, EarlyReflections::distanceR) + first,
+                    reflections.getTaps(image, EarlyReflections::delayL) + first, reflections.getTaps(image, EarlyReflections::delayR) + first,
+                    reflections.getTaps(image, EarlyReflections::gainL) + first, reflections.getTaps(image, EarlyReflections::gainR) + first);
+        reflections.finishTaps(image, first, lanes, (float)hrtfPartitionSize, scale.maxDelay);
+    }
+}
+
+void SpatialVoiceState::updateFilters(int v) noexcept
+{
+    if (v >= convolvers.size())
+        return;
+
+    // A changed filter is crossfaded in over the next partition
+    auto* convolver = convolvers.getUnchecked(v);
+    filterAzimuth[v] = azimuth[v];
+
+    for (auto ear : { HrtfSet::left, HrtfSet::right })
+    {
+        if (!hrtfEnabled)
+        {
+            convolver->setFilter(ear, hrtf.getIdentity());
+            continue;
+        }
+
+        float* slot = nullptr;
+
+        if (hrtf.isInterpolated())
+        {
+            for (int s = 0; s < hrtfSlotsPerEar && slot == nullptr; ++s)
+            {
+                auto* candidate = hrtfStorage.get() + (size_t)((v * 2 + ear) * hrtfSlotsPerEar + s) * (size_t)hrtfFilterSize;
+                if (!convolver->isReading(ear, candidate, candidate + hrtfFilterSize))
+                    slot = candidate;
+            }
+
+            // Head and tail crossfading out of two different slots still leaves one free
+            jassert(slot != nullptr);
+            if (slot == nullptr)
+                continue;
+        }
+
+        convolver->setFilter(ear, hrtf.getFilter(ear, azimuth[v], elevation[v], slot));
+    }
+}
+
+void SpatialVoiceState::clearVoiceBuffers(int numSamples) noexcept
+{
+    for (int v = 0; v < numVoices; ++v)
+    {
+        if (soundingVoices[(size_t)v] == 0)
+            continue;
+
+        voiceBuffers.clear(v, 0, numSamples);
+        soundingVoices[(size_t)v] = 0;
+    }
+}
+
+void SpatialVoiceState::setInterpolation(ItdDelayEngine::Interpolation interpolation) noexcept
+{
+    if (interpolation == currentInterpolation)
+        return;
+
+    // The minimum delay depends on the interpolator
+    currentInterpolation = interpolation;
+    for (auto* context : contexts)
+        context->itd.setInterpolation(interpolation);
+
+    std::fill(geometryDirty.begin(), geometryDirty.end(), (juce::uint8)1);
+}
+
+void SpatialVoiceState::setHrtfEnabled(bool shouldBeEnabled) noexcept
+{
+    if (shouldBeEnabled == hrtfEnabled)
+        return;
+
+    hrtfEnabled = shouldBeEnabled;
+    filters.setShadowEnabled(!hrtfEnabled);
+    std::fill(geometryDirty.begin(), geometryDirty.end(), (juce::uint8)1);
+}
+
+void SpatialVoiceState::process(juce::AudioBuffer<float>& output, int numSamples) noexcept
+{
+    jassert(numSamples <= voiceBuffers.getNumSamples());
+
+    auto* outL = output.getWritePointer(0);
+    auto* outR = output.getNumChannels() > 1 ? output.getWritePointer(1) : nullptr;
+
+    // Voices that didn't sound get one block closer to sleep, ones that start again after
+    // sleeping jump straight to where they are instead of gliding from where they were
+    int numAwake = 0;
+    bool anySounding = false;
+
+    for (int v = 0; v < numVoices; ++v)
+    {
+        const auto index = (size_t)v;
+        bool wakingUp = false;
+
+        if (soundingVoices[index] != 0)
+        {
+            if (silentSamples[index] >= drainSamples)
+            {
+                headL[index] = { delayL[v], gainL[v], 0.0f };
+                headR[index] = { delayR[v], gainR[v], 0.0f };
+                reflections.snap(v);
+                wakingUp = true;
+            }
+
+            silentSamples[index] = 0;
+            anySounding = true;
+        }
+
+        awakeVoices[index] = wakingUp ? wakingVoice : (silentSamples[index] < drainSamples ? 1 : 0);
+        numAwake += awakeVoices[index] != 0 ? 1 : 0;
+        silentSamples[index] = juce::jmin(drainSamples, silentSamples[index] + numSamples);
+    }
+
+    // One send for the whole pool, so the reverb costs the same however many voices play.
+    // It keeps running after the voices or the send stop until its tail has died away.
+    if (reverbSend > 0.0f && anySounding)
+        reverbTailRemaining = latencySamples + juce::roundToInt(getTailLengthSeconds(dimension, reflections.getReflectivity(), true) * hostSampleRate);
+
+    // Nothing to render, the output stays as it is. The motion carries on, so it's in the
+    // same place as it would have been.
+    if (numAwake == 0 && reverbTailRemaining <= 0)
+    {
+        if (trajectories.isMoving())
+            trajectories.advance(numSamples << oversamplingLog2);
+
+        idle = true;
+        return;
+    }
+
+    // The oversamplers were skipped while idle, whatever they held has long gone
+    if (idle && voiceOversampler != nullptr)
+    {
+        voiceOversampler->reset();
+        mixOversampler->reset();
+    }
+
+    idle = false;
+
+    if (reverbTailRemaining > 0)
+    {
+        BINAURAL_RAYS_PROFILE(profiler, reverb);
+        auto* send = sendBuffer.getWritePointer(0);
+        juce::FloatVectorOperations::clear(send, numSamples);
+
+        if (reverbSend > 0.0f && anySounding)
+        {
+            for (int v = 0; v < numVoices; ++v)
+                if (soundingVoices[(size_t)v] != 0)
+                    juce::FloatVectorOperations::add(send, voiceBuffers.getReadPointer(v), numSamples);
+
+            juce::FloatVectorOperations::multiply(send, reverbSend, numSamples);
+        }
+
+        reverb.process(send, outL, outR, numSamples);
+        reverbTailRemaining -= numSamples;
+    }
+
+    if (voiceOversampler == nullptr)
+    {
+        BINAURAL_RAYS_PROFILE(profiler, voices);
+        render(voiceBuffers.getArrayOfReadPointers(), outL, outR, numSamples);
+        return;
+    }
+
+    // Up to the internal rate, delays and HRIRs there, and the mix back down
+    juce::dsp::AudioBlock<float> mix(mixBuffer.getArrayOfWritePointers(), 2, (size_t)numSamples);
+    juce::dsp::AudioBlock<float> upMix;
+
+    {
+        BINAURAL_RAYS_PROFILE(profiler, oversampling);
+        juce::dsp::AudioBlock<float> voices(voiceBuffers.getArrayOfWritePointers(), (size_t)numVoices, (size_t)numSamples);
+        const auto upVoices = voiceOversampler->processSamplesUp(voices);
+
+        for (int v = 0; v < numVoices; ++v)
+            oversampledVoices[(size_t)v] = upVoices.getChannelPointer((size_t)v);
+
+        mix.clear();
+        upMix = mixOversampler->processSamplesUp(mix);
+        upMix.clear();
+    }
+
+    {
+        BINAURAL_RAYS_PROFILE(profiler, voices);
+        render(oversampledVoices.data(), upMix.getChannelPointer(0), upMix.getChannelPointer(1), (int)upMix.getNumSamples());
+    }
+
+    {
+        BINAURAL_RAYS_PROFILE(profiler, oversampling);
+        mixOversampler->processSamplesDown(mix);
+    }
+
+    if (outR != nullptr)
+    {
+        juce::FloatVectorOperations::add(outL, mixBuffer.getReadPointer(0), numSamples);
+        juce::FloatVectorOperations::add(outR, mixBuffer.getReadPointer(1), numSamples);
+    }
+    else
+    {
+        juce::FloatVectorOperations::addWithMultiply(outL, mixBuffer.getReadPointer(0), 0.5f, numSamples);
+        juce::FloatVectorOperations::addWithMultiply(outL, mixBuffer.getReadPointer(1), 0.5f, numSamples);
+    }
+}
+
+void SpatialVoiceState::encodeAmbisonics(float* const* channels, int numSamples) noexcept
+{
+    if (ambisonics.getOrder() == 0)
+        return;
+
+    // Where each voice ended up this block, at the level between its ears. Voices go on
+    // through their rings until they sleep, and once the delay has emptied there's nothing
+    // to encode.
+    const int factor = 1 << oversamplingLog2;
+    const int mask = ambisonicDelays.getMask();
+    const int firstPart = juce::jmin(numSamples, ambisonicDelays.getRingSize() - ambisonicWritePos);
+    const float minDelay = ambisonicReader.getMinimumDelay();
+    auto* delayed = ambisonicInput.getWritePointer(0);
+    bool anyAwake = false;
+
+    for (int v = 0; v < numVoices; ++v)
+    {
+        if (awakeVoices[(size_t)v] == 0)
+            continue;
+
+        const auto* in = voiceBuffers.getReadPointer(v);
+        auto* ring = ambisonicDelays.getRing(v);
+        juce::FloatVectorOperations::copy(ring + ambisonicWritePos, in, firstPart);
+        juce::FloatVectorOperations::copy(ring, in + firstPart, numSamples - firstPart);
+
+        // Halfway between the ears' delays, at the host rate, and ramped there the same way
+        const float delay = juce::jmax(minDelay, 0.5f * (delayL[v] + delayR[v]) / (float)factor);
+        auto& head = ambisonicHeads[(size_t)v];
+
+        if (awakeVoices[(size_t)v] == wakingVoice)
+            head = { delay, 1.0f, 0.0f };
+
+        juce::FloatVectorOperations::clear(delayed, numSamples);
+        ambisonicReader.process(ring, mask, ambisonicWritePos, head, delay, 1.0f, delayed, numSamples);
+
+        ambisonics.setSource(v, azimuth[v], elevation[v], 0.5f * (gainL[v] + gainR[v]));
+        ambisonics.addSource(v, delayed, numSamples);
+        anyAwake = true;
+    }
+
+    ambisonicWritePos = (ambisonicWritePos + numSamples) & mask;
+
+    if (anyAwake)
+        ambisonicSilence = 0;
+    else if (ambisonicSilence >= drainSamples)
+    {
+        for (int c = 0; c < ambisonics.getNumChannels(); ++c)
+            juce::FloatVectorOperations::clear(channels[c], numSamples);
+
+        return;
+    }
+
+    ambisonicSilence = juce::jmin(drainSamples, ambisonicSilence + numSamples);
+    ambisonics.process(channels, numSamples);
+}
+
+void SpatialVoiceState::render(const float* const* inputs, float* outL, float* outR, int numSamples) noexcept
+{
+    jassert(numSamples <= internalBlockSize);
+
+    // Once the motion stops every voice glides back to where it was placed
+    const bool moving = trajectories.isMoving();
+    if (trajectoryWasMoving && !moving)
+        std::fill(geometryDirty.begin(), geometryDirty.end(), (juce::uint8)1);
+    trajectoryWasMoving = moving;
+
+    if (snapHeads)
+    {
+        for (int v = 0; v < numVoices; ++v)
+        {
+            headL[v] = { delayL[v], gainL[v], 0.0f };
+            headR[v] = { delayR[v], gainR[v], 0.0f };
+            reflections.snap(v);
+        }
+
+        snapHeads = false;
+    }
+
+    const RenderBlock block { inputs, numSamples, moving, reflections.getNumImages() > 0, getEarScale() };
+    auto render = [this, &block](int chunk, int worker) { renderChunk(chunk, *contexts.getUnchecked(worker), block); };
+
+    if (workerPool != nullptr)
+        workerPool->run(numChunks, render);
+    else
+        for (int chunk = 0; chunk < numChunks; ++chunk)
+            render(chunk, 0);
+
+    // Always in chunk order, whichever thread finished first
+    for (int chunk = 0; chunk < numChunks; ++chunk)
+    {
+        const auto* chunkL = chunkMixes.getReadPointer(chunk * 2);
+        const auto* chunkR = chunkMixes.getReadPointer(chunk * 2 + 1);
+
+        if (outR != nullptr)
+        {
+            juce::FloatVectorOperations::add(outL, chunkL, numSamples);
+            juce::FloatVectorOperations::add(outR, chunkR, numSamples);
+        }
+        else
+        {
+            // Mono output gets both ears
+            juce::FloatVectorOperations::addWithMultiply(outL, chunkL, 0.5f, numSamples);
+            juce::FloatVectorOperations::addWithMultiply(outL, chunkR, 0.5f, numSamples);
+        }
+    }
+
+    if (moving)
+        trajectories.advance(numSamples);
+
+    writePos = (writePos + numSamples) & (delaySize - 1);
+}
+
+void SpatialVoiceState::renderChunk(int chunk, RenderContext& context, const RenderBlock& block) noexcept
+{
+    const int numSamples = block.numSamples;
+    const int mask = delaySize - 1;
+    const int firstPart = juce::jmin(numSamples, delaySize - writePos);
+    const int endVoice = juce::jmin(numVoices, (chunk + 1) * voicesPerChunk);
+
+    auto* mixL = chunkMixes.getWritePointer(chunk * 2);
+    auto* mixR = chunkMixes.getWritePointer(chunk * 2 + 1);
+    juce::FloatVectorOperations::clear(mixL, numSamples);
+    juce::FloatVectorOperations::clear(mixR, numSamples);
+
+    // A SIMD register of voices at a time, so their ear filters run side by side
+    float* ears[SourceFilterBank::lanes * 2];
+
+    // Where each moving voice of the register ends the block, for its reflections
+    alignas(Vec::SIMDRegisterSize) float endX[lanes];
+    alignas(Vec::SIMDRegisterSize) float endY[lanes];
+
+    for (int first = chunk * voicesPerChunk; first < endVoice; first += lanes)
+    {
+        const int count = juce::jmin(lanes, endVoice - first);
+
+        // Sleeping voices' rings are clear and stay so, a register with none awake is skipped
+        bool anyAwake = false;
+        for (int l = 0; l < count; ++l)
+            anyAwake = anyAwake || awakeVoices[(size_t)(first + l)] != 0;
+
+        if (!anyAwake)
+            continue;
+
+        for (int l = 0; l < count; ++l)
+        {
+            const int v = first + l;
+            const auto* in = block.inputs[v];
+            auto* ring = delays.getRing(v);
+            auto* voiceEars = ears + l * 2;
+
+            // The block goes into the ring first, then both ears read it back
+            juce::FloatVectorOperations::copy(ring + writePos, in, firstPart);
+            juce::FloatVectorOperations::copy(ring, in + firstPart, numSamples - firstPart);
+
+            voiceEars[0] = context.earBuffer.getWritePointer(l * 2);
+            voiceEars[1] = context.earBuffer.getWritePointer(l * 2 + 1);
+            juce::FloatVectorOperations::clear(voiceEars[0], numSamples);
+            juce::FloatVectorOperations::clear(voiceEars[1], numSamples);
+
+            if (block.moving)
+            {
+                processTrajectory(context, v, ring, voiceEars, numSamples);
+                endX[l] = context.pathX[numSamples - 1];
+                endY[l] = context.pathY[numSamples - 1];
+            }
+            else
+            {
+                context.itd.process(ring, mask, writePos, headL[v], delayL[v], gainL[v], voiceEars[0], numSamples);
+                context.itd.process(ring, mask, writePos, headR[v], delayR[v], gainR[v], voiceEars[1], numSamples);
+            }
+        }
+
+        // Moving sources reflect from somewhere new every block
+        if (block.moving && block.reflecting)
+        {
+            std::fill(endX + count, endX + lanes, posX[first]);
+            std::fill(endY + count, endY + lanes, posY[first]);
+            updateReflections(block.scale, first, endX, endY);
+        }
+
+        // Delayed ears, then air absorption and shadowing, then their HRIRs and the
+        // reflections, then the mix
+        filters.process(first, ears, count, numSamples, context.filterScratch);
+
+        for (int l = 0; l < count; ++l)
+        {
+            auto* voiceEars = ears + l * 2;
+            convolvers.getUnchecked(first + l)->process(voiceEars, voiceEars, numSamples);
+
+            if (block.reflecting)
+                reflections.process(context.reflectionReader, first + l, delays.getRing(first + l), mask, writePos, voiceEars, numSamples);
+
+            juce::FloatVectorOperations::add(mixL, voiceEars[0], numSamples);
+            juce::FloatVectorOperations::add(mixR, voiceEars[1], numSamples);
+        }
+    }
+}
+
+void SpatialVoiceState::processTrajectory(RenderContext& context, int v, const float* ring, float* const* ears, int numSamples) noexcept
+{
+    const int mask = delaySize - 1;
+    const int count = (numSamples + lanes - 1) / lanes * lanes;
+    auto** path = context.pathArrays;
+    const auto scale = getEarScale();
+
+    trajectories.render(v, posX[v], posY[v], numSamples, context.pathX, context.pathY);
+    computeEars(scale, context.pathX, context.pathY, count,
+                path[0], path[1], path[2], path[3], path[4], path[5]);
+
+    // Where the block ends is where a stopped trajectory glides back from
+    const int last = numSamples - 1;
+    distanceL[v] = path[0][last];
+    distanceR[v] = path[1][last];
+    delayL[v] = path[2][last];
+    delayR[v] = path[3][last];
+    gainL[v] = path[4][last];
+    gainR[v] = path[5][last];
+
+    // A voice that slept through the motion starts where the path is now
+    if (awakeVoices[(size_t)v] == wakingVoice)
+    {
+        headL[v] = { path[2][0], path[4][0], 0.0f };
+        headR[v] = { path[3][0], path[5][0], 0.0f };
+    }
+
+    context.itd.process(ring, mask, writePos, headL[v], path[2], path[4], ears[0], numSamples);
+    context.itd.process(ring, mask, writePos, headR[v], path[3], path[5], ears[1], numSamples);
+
+    // HRIRs follow once per block, and only once the source has turned far enough to hear
+    constexpr float filterStep = juce::MathConstants<float>::pi / 180.0f;
+    const float centreX = (leftEarX + rightEarX) * 0.5f;
+    const float centreY = (leftEarY + rightEarY) * 0.5f;
+
+    azimuth[v] = std::atan2(context.pathX[last] - centreX, context.pathY[last] - centreY);
+    filters.setSource(v, distanceL[v] * scale.toMeters, distanceR[v] * scale.toMeters, azimuth[v]);
+
+    auto turned = std::abs(azimuth[v] - filterAzimuth[v]);
+    turned = juce::jmin(turned, juce::MathConstants<float>::twoPi - turned);
+
+    if (turned >= filterStep)
+        updateFilters(v);
+}
@@ -0,0 +1,317 @@
+/*
+  ==============================================================================
+
+    SpatialVoiceState.h
+    Created: 17 Oct 2026 10:12:03am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ItdDelayEngine.h"
+#include "HrtfSet.h"
+#include "DelayArena.h"
+#include "SceneSnapshot.h"
+#include "TrajectoryEngine.h"
+#include "SourceFilterBank.h"
+#include "EarlyReflections.h"
+#include "LateReverb.h"
+#include "AmbisonicEncoder.h"
+#include "RealtimeWorkerPool.h"
+#include "DspProfiler.h"
+
+// Spatial scene of every voice in the pool, each one an independently placed source.
+// Positions, ear distances, ITD delays and gains are kept as SIMD aligned
+// structure-of-arrays, so the distance math runs a SIMD register of sources at a time.
+// Every voice's delay line (one ring, read by one head per ear) is carved out of one
+// cache-aligned DelayArena sized in prepare(), instead of one heap delay line per note.
+// After the delay, each ear gets a high shelf for air absorption and head shadowing
+// (SourceFilterBank, a SIMD register of voices at a time) and a partitioned HRIR
+// convolution picked from the voice's azimuth.
+//
+// While a trajectory is running, every voice moves along it around its own position and
+// gets a new delay on every sample. The box's walls add image source early reflections
+// (EarlyReflections), more taps on the same ring, and a late reverb (LateReverb) fed by
+// one send from the whole pool.
+//
+// All of that can run oversampled: the voices are rendered at the host rate, brought up
+// to the internal rate for the delays and HRIRs, and the stereo mix is brought back down.
+//
+// A voice that hasn't sounded for long enough for its delay line, filters and HRIRs to
+// have drained goes to sleep, and costs nothing until it sounds again. Once every voice
+// is asleep and the reverb has died away, process() doesn't do anything at all.
+//
+// With a RealtimeWorkerPool the voices are rendered in fixed chunks spread over its
+// threads, each thread with its own scratch. Every chunk is mixed on its own and the
+// chunks are summed in order, so the output is bit for bit the same with any number
+// of threads.
+class SpatialVoiceState
+{
+public:
+    static constexpr int minVoices = 16;
+    static constexpr int maxVoices = 512;
+
+    // Speed of sound in m/s, used to turn ear distances into delays
+    static constexpr float speedOfSound = 343.0f;
+
+    explicit SpatialVoiceState(int numVoices);
+
+    // sampleRate and samplesPerBlock are the host's, the spatial processing runs at
+    // that times the oversampling factor
+    void prepare(double sampleRate, int samplesPerBlock, float maxDimension);
+    void reset();
+
+    // Voices are rendered on the pool's threads from the next prepare() on, nullptr
+    // renders them all on the audio thread. The pool has to outlive us.
+    void setWorkerPool(RealtimeWorkerPool* pool) noexcept { workerPool = pool; }
+
+    // Times the reverb, oversampling and voice stages of process(), may be null
+    void setProfiler(DspProfiler* newProfiler) noexcept { profiler = newProfiler; }
+
+    // Takes effect on the next prepare(). factorLog2 is 0 to 3 (1x to 8x), the filters are
+    // either polyphase IIR (less latency) or linear phase FIR (no phase distortion).
+    void setOversampling(int factorLog2, bool linearPhase) noexcept;
+    int getOversamplingFactor() const noexcept { return 1 << oversamplingLog2; }
+
+    int getNumVoices() const noexcept { return numVoices; }
+
+    // The position new notes are placed at. A voice keeps the position that was
+    // current when its note started, so simultaneous notes can sit in different places.
+    void setNextNotePosition(float x, float y) noexcept;
+    void assignNotePosition(int voiceIndex) noexcept;
+    void setVoicePosition(int voiceIndex, float x, float y) noexcept;
+
+    // Moves every voice to its source in the scene at once, sounding ones included, and
+    // places new notes there too until the next setNextNotePosition()
+    void applyScene(const SceneSnapshot& newScene) noexcept;
+
+    // Size of the box in meters, every voice's geometry is recomputed on the next update
+    void setDimension(float newDimension) noexcept;
+
+    // Wall reflections up to this many bounces, 0 for none. Takes effect on the next
+    // prepare(), which makes the rings long enough for the furthest image.
+    void setReflectionOrder(int order) noexcept { reflections.setOrder(order); }
+    int getReflectionOrder() const noexcept { return reflections.getOrder(); }
+
+    // Ambisonic order of encodeAmbisonics(), 0 for none. Takes effect on the next prepare().
+    void setAmbisonicOrder(int order) noexcept { ambisonicOrder = juce::jlimit(0, AmbisonicEncoder::maxOrder, order); }
+    int getNumAmbisonicChannels() const noexcept { return ambisonics.getNumChannels(); }
+
+    // After process(), the direct sound of every voice as ambisonics (ACN/SN3D) into
+    // getNumAmbisonicChannels() channels, lined up with the binaural output: each voice
+    // is delayed by its distance, as the ears hear it, then by the binaural latency. The
+    // room isn't in it, that's left to the decoder's end.
+    void encodeAmbisonics(float* const* channels, int numSamples) noexcept;
+
+    // Fraction of the level each bounce keeps, for the reflections and the reverb's decay
+    void setReflectivity(float reflectivity) noexcept;
+
+    // Level of every voice in the reverb's send, and its 8 or 16 delay lines
+    void setReverb(float send, int numLines) noexcept;
+
+    // How long the output keeps going after the voices stop, on top of the latency: the
+    // furthest ear, the HRIRs, and the room's reflections and reverb
+    double getTailLengthSeconds(float dimension, float reflectivity, bool reverbOn) const noexcept;
+
+    // Recomputes ear distances, delays and gains of the voices whose geometry is out of date
+    void updateGeometry() noexcept;
+
+    // Motion paths, set up by the caller once per block before process()
+    TrajectoryEngine& getTrajectories() noexcept { return trajectories; }
+
+    // Mono render target of one voice for the current block. Asking for it counts the
+    // voice as sounding this block, which wakes it up.
+    float* getVoiceBuffer(int voiceIndex) noexcept
+    {
+        soundingVoices[(size_t)voiceIndex] = 1;
+        return voiceBuffers.getWritePointer(voiceIndex);
+    }
+
+    // Only the buffers that were rendered into, the others are still clear
+    void clearVoiceBuffers(int numSamples) noexcept;
+
+    void setInterpolation(ItdDelayEngine::Interpolation interpolation) noexcept;
+
+    // false swaps every voice to the identity filter, the latency stays the same
+    void setHrtfEnabled(bool shouldBeEnabled) noexcept;
+
+    // Measured HRIRs to use from the next prepare() on, if they were built for its
+    // sample rate. nullptr goes back to the head shadow model.
+    void setHrtfDatabase(std::shared_ptr<const HrtfDatabase> database) { hrtfDatabase = std::move(database); }
+
+    // Added by the HRIR convolution and the oversampling filters, at the host rate and
+    // constant once prepared
+    int getLatencySamples() const noexcept { return latencySamples; }
+
+    // Runs every voice through its own delay/gain and sums them into the output
+    void process(juce::AudioBuffer<float>& output, int numSamples) noexcept;
+
+    // Measured HRIRs have to match the rate the convolution runs at
+    static double getInternalSampleRate(double sampleRate, int factorLog2) noexcept { return sampleRate * (1 << factorLog2); }
+
+private:
+    int numVoices;
+
+    // maxDistance is the distance from the upper left to the upper right corner of the virtual square,
+    // and all the other dimensions are derived from it.
+    const float maxDistance = 100.0f;
+    const float rightEarX = (maxDistance / 2) + 0.2f * maxDistance;
+    const float leftEarX = (maxDistance / 2) - 0.2f * maxDistance;
+    const float rightEarY = 50;
+    const float leftEarY = 50;
+    const float maxDistanceToEar = std::sqrt((maxDistance - leftEarX) * (maxDistance - leftEarX) + (maxDistance - leftEarY) * (maxDistance - leftEarY));
+
+    // Structure-of-arrays, one entry per voice, all in soaStorage. Each array starts
+    // on a cache line and is padded to whole SIMD registers.
+    juce::HeapBlock<float> soaStorage;
+    int soaStride = 0;
+    float* posX = nullptr;
+    float* posY = nullptr;
+    float* distanceL = nullptr;
+    float* distanceR = nullptr;
+    float* delayL = nullptr;
+    float* delayR = nullptr;
+    float* gainL = nullptr;
+    float* gainR = nullptr;
+    float* azimuth = nullptr;
+    float* elevation = nullptr;
+    float* filterAzimuth = nullptr;     // azimuth the current HRIRs were picked for
+    std::vector<ItdDelayEngine::Head> headL, headR;  // where the ramps got to last block
+    std::vector<juce::uint8> geometryDirty;
+
+    // Sleep. A voice is awake while it has been silent for less than drainSamples, which
+    // covers the whole ring, the HRIRs, the filters and the oversamplers.
+    std::vector<juce::uint8> soundingVoices;        // rendered into this block
+    std::vector<juce::uint8> awakeVoices;           // rendered by process() this block
+    static constexpr juce::uint8 wakingVoice = 2;   // in awakeVoices, sounding again after sleeping
+    std::vector<int> silentSamples;                 // since each voice last sounded, host rate
+    int drainSamples = 0;
+    int ambisonicSilence = 0;                       // since any voice was last awake, host rate
+    bool idle = true;                               // process() skipped the last block
+    double responseSeconds = 0.0;                   // of the HRIRs
+
+    float dimension = 1.0f;
+    ItdDelayEngine::Interpolation currentInterpolation = ItdDelayEngine::Interpolation::lagrange3;
+
+    float nextX = 50.0f;
+    float nextY = 50.0f;
+    SceneSnapshot scene;
+    bool sceneActive = false;
+
+    juce::AudioBuffer<float> voiceBuffers;  // one mono channel per voice
+    DelayArena delays;                      // one ring per voice
+    int delaySize = 0;                      // power of two, shared by every ring
+    int writePos = 0;                       // all rings advance together
+    double currentSampleRate = 44100.0;
+    bool snapHeads = true;                  // jump straight to the targets after a reset
+
+    // Interpolated filters are written per voice and ear into one of a few slots, never
+    // into one the convolver is still reading (it may be crossfading out of it)
+    static constexpr int hrtfSlotsPerEar = 3;
+    void updateFilters(int voiceIndex) noexcept;
+
+    // Distance to delay and gain conversion for the current dimension and sample rate
+    struct EarScale
+    {
+        float toMeters, toSamples, minDelay, maxDelay;
+    };
+
+    EarScale getEarScale() const noexcept;
+
+    // Distances, delays and gains of both ears for count positions, a SIMD register at
+    // a time. Every pointer is SIMD aligned and count is a whole number of registers.
+    void computeEars(const EarScale& scale, const float* x, const float* y, int count,
+                     float* distL, float* distR, float* dlyL, float* dlyR, float* gnL, float* gnR) const noexcept;
+
+    // Everything one thread needs to render voices, so that several can at once
+    struct RenderContext
+    {
+        ItdDelayEngine itd;
+        ItdDelayEngine reflectionReader;        // linear
+        juce::AudioBuffer<float> earBuffer;     // both ears of each voice in the SIMD group being processed
+        juce::HeapBlock<float> storage;
+        float* pathArrays[6] = {};              // distance, delay and gain per ear, one block each
+        float* pathX = nullptr;                 // trajectory positions, one block each
+        float* pathY = nullptr;
+        float* filterScratch = nullptr;
+    };
+
+    // What every chunk of one block needs to know
+    struct RenderBlock
+    {
+        const float* const* inputs;
+        int numSamples;
+        bool moving, reflecting;
+        EarScale scale;
+    };
+
+    // Fixed, whatever the number of threads, so the mix is too
+    static constexpr int voicesPerChunk = 32;
+    static_assert(voicesPerChunk % SourceFilterBank::lanes == 0, "chunks have to be whole SIMD groups");
+
+    // Everything after the voices, at the internal rate. inputs has one mono block per voice.
+    void render(const float* const* inputs, float* outL, float* outR, int numSamples) noexcept;
+
+    // One chunk of voices into its own stereo mix
+    void renderChunk(int chunk, RenderContext& context, const RenderBlock& block) noexcept;
+
+    // Per sample geometry of the voice being moved along its trajectory
+    void processTrajectory(RenderContext& context, int voiceIndex, const float* ring, float* const* ears, int numSamples) noexcept;
+
+    // Reflection taps of the SIMD register of voices starting at first, placed at x, y
+    void updateReflections(const EarScale& scale, int first, const float* x, const float* y) noexcept;
+
+    EarlyReflections reflections;
+
+    // Predelayed so the tail starts behind the direct sound, whatever the latency
+    void updateReverbRoom() noexcept;
+
+    // At the host rate. Every voice goes through its own ring first, read at the mean of
+    // its ears' delays, so the encoder hears it when the ears do.
+    AmbisonicEncoder ambisonics;
+    int ambisonicOrder = 0;
+    DelayArena ambisonicDelays;                         // one ring per voice, only while the bus is on
+    int ambisonicWritePos = 0;
+    ItdDelayEngine ambisonicReader;
+    std::vector<ItdDelayEngine::Head> ambisonicHeads;
+    juce::AudioBuffer<float> ambisonicInput;            // one voice's block, delayed
+
+    LateReverb reverb;                  // at the host rate, a tail doesn't need more
+    juce::AudioBuffer<float> sendBuffer;
+    float reverbSend = 0.0f;
+    int reverbTailRemaining = 0;        // samples the tail keeps going once the send is closed
+    double hostSampleRate = 44100.0;
+
+    TrajectoryEngine trajectories;
+    bool trajectoryWasMoving = false;
+
+    RealtimeWorkerPool* workerPool = nullptr;
+    DspProfiler* profiler = nullptr;
+    juce::OwnedArray<RenderContext> contexts;   // one per thread, the first is the audio thread's
+    juce::AudioBuffer<float> chunkMixes;        // left and right of every chunk
+    int numChunks = 0;
+
+    HrtfSet hrtf;
+    std::shared_ptr<const HrtfDatabase> hrtfDatabase;
+    juce::HeapBlock<float> hrtfStorage;                 // voice, ear, slot
+    int hrtfFilterSize = 0;
+    juce::OwnedArray<PartitionedConvolver> convolvers;  // one per voice, two channels each
+    SourceFilterBank filters;                           // air absorption, and head shadow while the HRIRs are off
+    int hrtfPartitionSize = 0;
+    bool hrtfEnabled = true;
+
+    // Voices go up on one oversampler, the stereo mix comes down on another with the
+    // same filters, so together they add exactly one oversampler's latency
+    int oversamplingLog2 = 0;
+    bool oversamplingLinearPhase = false;
+    std::unique_ptr<juce::dsp::Oversampling<float>> voiceOversampler, mixOversampler;
+    std::vector<const float*> oversampledVoices;    // channel pointers of the upsampled block
+    juce::AudioBuffer<float> mixBuffer;             // stereo mix at the host rate
+    int internalBlockSize = 0;
+    int latencySamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(SpatialVoiceState)
+};
@@ -1,5 +1,3 @@
-#pragma once
-
 #include "SynthParameters.h"
 
 template<typename T>
@@ -9,19 +7,75 @@ SynthParameters<T>::~SynthParameters()
 }
 
 template<typename T>
-void SynthParameters<T>::add(T* parameterPtr)
+typename SynthParameters<T>::Handle SynthParameters<T>::add(const juce::AudioProcessorValueTreeState& apvts,
+                                                            const juce::String& parameterID, double rampSeconds)
 {
-    parameters.push_back(parameterPtr);
+    Entry entry;
+    entry.raw = apvts.getRawParameterValue(parameterID);
+    jassert(entry.raw != nullptr); // unknown parameter ID
+
+    entry.rampSeconds = rampSeconds;
+    entry.target = entry.current = (T)entry.raw->load();
+    entry.smoothed.setCurrentAndTargetValue(entry.current);
+
+    entries.push_back(entry);
+    return { (int)entries.size() - 1 };
 }
 
 template<typename T>
 void SynthParameters<T>::clear()
 {
-    parameters.clear(); // No borra los punteros. Si quieres borrarlos, haz un delete
+    entries.clear(); // No borra los punteros, son del apvts
+    blockValues.free();
+    blockStride = 0;
+}
+
+template<typename T>
+void SynthParameters<T>::prepare(double sampleRate, int maxBlockSize)
+{
+    blockStride = maxBlockSize;
+    blockValues.allocate((size_t)juce::jmax(1, size() * blockStride), true);
+
+    for (auto& entry : entries)
+    {
+        entry.target = entry.current = (T)entry.raw->load();
+        entry.smoothed.reset(sampleRate, entry.rampSeconds);
+        entry.smoothed.setCurrentAndTargetValue(entry.current);
+        ++entry.version;
+    }
 }
 
 template<typename T>
-const std::vector<T*>& SynthParameters<T>::getAll() const
+void SynthParameters<T>::update(int numSamples) noexcept
 {
-    return parameters;
+    jassert(numSamples <= blockStride);
+
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        auto& entry = entries[i];
+        auto* values = blockValues.get() + i * (size_t)blockStride;
+
+        const auto newTarget = (T)entry.raw->load();
+
+        if (newTarget != entry.target)
+        {
+            entry.target = newTarget;
+            entry.smoothed.setTargetValue(newTarget);
+            ++entry.version;
+        }
+
+        if (entry.smoothed.isSmoothing())
+        {
+            for (int n = 0; n < numSamples; ++n)
+                values[n] = entry.smoothed.getNextValue();
+        }
+        else
+        {
+            std::fill(values, values + numSamples, entry.target);
+        }
+
+        entry.current = entry.smoothed.getCurrentValue();
+    }
 }
+
+template class SynthParameters<float>;
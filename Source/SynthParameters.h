@@ -1,18 +1,62 @@
 #pragma once
 
+#include <JuceHeader.h>
 #include <vector>
 
+// Registry of the processor's parameters. Each one is resolved to its raw atomic
+// once, when it is added, and update() then turns the whole set into per-block
+// data for the audio thread: a SmoothedValue ramp written into one contiguous
+// array per parameter, and a version counter that changes whenever the value does,
+// so derived state (e.g. geometry) is only recomputed when it needs to be.
 template<typename T>
 class SynthParameters
 {
 public:
+    // Typed index into the registry, cheap to copy around
+    struct Handle
+    {
+        int index = -1;
+        bool isValid() const noexcept { return index >= 0; }
+    };
+
     SynthParameters() = default;
     ~SynthParameters();
 
-    void add(T* parameterPtr);
+    // rampSeconds = 0 means the value jumps instead of gliding
+    Handle add(const juce::AudioProcessorValueTreeState& apvts, const juce::String& parameterID, double rampSeconds = 0.0);
     void clear();
-    const std::vector<T*>& getAll() const;
+
+    // Allocates the per-block arrays, call from prepareToPlay
+    void prepare(double sampleRate, int maxBlockSize);
+
+    // Reads every parameter and fills its array for the next numSamples
+    void update(int numSamples) noexcept;
+
+    // Value at the end of the current block
+    T get(Handle handle) const noexcept { return entries[(size_t)handle.index].current; }
+
+    // numSamples values for the current block, one per sample
+    const T* getBlock(Handle handle) const noexcept { return blockValues.get() + (size_t)handle.index * (size_t)blockStride; }
+
+    bool isSmoothing(Handle handle) const noexcept { return entries[(size_t)handle.index].smoothed.isSmoothing(); }
+
+    // Bumped every time the parameter's target changes
+    juce::uint32 getVersion(Handle handle) const noexcept { return entries[(size_t)handle.index].version; }
+
+    int size() const noexcept { return (int)entries.size(); }
 
 private:
-    std::vector<T*> parameters;
-};
\ No newline at end of file
+    struct Entry
+    {
+        std::atomic<float>* raw = nullptr;
+        juce::SmoothedValue<T> smoothed;
+        double rampSeconds = 0.0;
+        T target{};
+        T current{};
+        juce::uint32 version = 0;
+    };
+
+    std::vector<Entry> entries;
+    juce::HeapBlock<T> blockValues;     // parameter after parameter, blockStride apart
+    int blockStride = 0;
+};
@@ -18,7 +18,10 @@ bool SynthVoice::canPlaySound(juce::SynthesiserSound* sound)
 
 void SynthVoice::startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound* sound, int currentPitchWheelPosition)
 {
-    osc.setFrequency(juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber));
+    // The pitch comes from the sweep, the note only starts the voice
+    oscillators.resetPhase(voiceIndex);
+    noise.resetVoice(voiceIndex);
+    spatialState.assignNotePosition(voiceIndex);
     adsr.noteOn();
 }
 
@@ -37,33 +40,31 @@ void SynthVoice::pitchWheelMoved(int newPitchWheelValue)
 
 }
 
-void SynthVoice::updateParams(const juce::AudioProcessorValueTreeState& apvts)
+void SynthVoice::updateParams(const Parameters& registry, Parameters::Handle gainHandle)
 {
-    lfoSpeed = apvts.getRawParameterValue("lfoSpeed");
-    minFreq = apvts.getRawParameterValue("minFreq");
-    maxFreq = apvts.getRawParameterValue("maxFreq");
-    zDepth = apvts.getRawParameterValue("gain");
+    params = &registry;
+    zDepth = gainHandle;
 }
 
-void SynthVoice::prepareToPlay(double sampleRate, int samplesPerBlock, int outputChannels)
+void SynthVoice::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     adsr.setSampleRate(sampleRate);
 
     adsr.setParameters(adsrParams);
 
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = outputChannels;
+    synthBuffer.setSize(1, samplesPerBlock);
 
-    osc.prepare(spec);
-    gain.prepare(spec);
-    gain.setGainLinear(0.5f);
-    // Prepare delay lines
+    isPrepared = true;
+}
 
-    synthBuffer.setSize(outputChannels, samplesPerBlock);
+void SynthVoice::updateOscillator(int startSample, int numSamples)
+{
+    const auto* frequencies = modulation.process(voiceIndex, startSample, numSamples);
+    oscillators.setFrequencies(voiceIndex, frequencies, startSample, numSamples);
 
-    isPrepared = true;
+    // Band noise sits on the middle of the sub-block's sweep
+    if (noise.getColour() == NoiseBank::Colour::band)
+        noise.setCentreFrequency(voiceIndex, frequencies[startSample + numSamples / 2]);
 }
 
 void SynthVoice::renderNextBlock(juce::AudioBuffer< float >& outputBuffer, int startSample, int numSamples)
@@ -73,75 +74,29 @@ void SynthVoice::renderNextBlock(juce::AudioBuffer< float >& outputBuffer, int s
     if (!isVoiceActive())
         return;
 
-    // Create a temporary mono buffer for oscillator output
-    juce::AudioBuffer<float> monoBuffer(1, numSamples);
-    monoBuffer.clear();
-
-    // Clear our internal buffer (stereo)
-    synthBuffer.clear();
-
-    // Pitch Oscillator
-    float currentFreq = 400;
-    float lfoSpeedFloat = lfoSpeed->load();
-    float minFreqFloat = minFreq->load();
-    float maxFreqFloat = maxFreq->load();
-    float zSliderFloat = zDepth->load();
-
-    if (lfoSpeed != nullptr && minFreq != nullptr) {
-
-        // Velocidad del cambio de pitch
-        lfoPhase += 2000*lfoSpeedFloat / currentSampleRate;
-        if (lfoPhase >= 1.0f)
-            lfoPhase -= 1.0f;
-
-        // 1. Actualizar LFO (sinusoidal)
-        lfoPhase += lfoFreq / currentSampleRate;
-        if (lfoPhase >= 1.0f) lfoPhase -= 1.0f;
+    jassert(numSamples <= synthBuffer.getNumSamples());
 
-        // 2. Calcular frecuencia actual
-        const float lfoValue = std::sin(2.0f * juce::MathConstants<float>::pi * lfoPhase);
-        currentFreq = minFreqFloat + (maxFreqFloat - minFreqFloat) * (0.5f + 0.5f * lfoValue);
+    // The bank has already rendered this voice's oscillator, or its noise, for the sub-block
+    const auto* source = noise.isEnabled() ? noise.getOutput(voiceIndex) : oscillators.getOutput(voiceIndex);
+    synthBuffer.copyFrom(0, 0, source + startSample, numSamples);
 
-        osc.setFrequency(currentFreq);
-        gain.setGainLinear(zSliderFloat/6);
-    }
-
-
-    juce::dsp::AudioBlock<float> audioBlock{ synthBuffer };
-    osc.process(juce::dsp::ProcessContextReplacing<float>(audioBlock));
-    gain.process(juce::dsp::ProcessContextReplacing<float>(audioBlock));
-    adsr.applyEnvelopeToBuffer(synthBuffer, startSample, synthBuffer.getNumSamples());
-    // Handles stereo
-    for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel)
+    // Gain follows its smoothed ramp; synthBuffer[0] lines up with startSample of the block
+    if (params != nullptr)
     {
-        outputBuffer.addFrom(channel, startSample,
-            synthBuffer, channel % synthBuffer.getNumChannels(),
-            0, numSamples);
+        auto* samples = synthBuffer.getWritePointer(0);
+        juce::FloatVectorOperations::multiply(samples, params->getBlock(zDepth) + startSample, numSamples);
+        juce::FloatVectorOperations::multiply(samples, 1.0f / 6.0f, numSamples);
     }
 
+    // Only the sub-block, so the envelope moves on by exactly numSamples
+    adsr.applyEnvelopeToBuffer(synthBuffer, 0, numSamples);
+    // Mono into this voice's slot, the spatial stage does the stereo
+    juce::FloatVectorOperations::add(spatialState.getVoiceBuffer(voiceIndex) + startSample,
+        synthBuffer.getReadPointer(0), numSamples);
+
 
 
     if (!adsr.isActive())
         clearCurrentNote();
 
 }
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
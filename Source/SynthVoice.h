@@ -12,11 +12,18 @@
 
 #include <JuceHeader.h>
 #include "SynthSound.h"
+#include "SpatialVoiceState.h"
+#include "SynthParameters.h"
+#include "WavetableOscillator.h"
+#include "NoiseBank.h"
+#include "ModulationEngine.h"
 
 class SynthVoice : public juce::SynthesiserVoice
 {
 public:
-    SynthVoice()
+    SynthVoice(int index, SpatialVoiceState& spatial, WavetableOscillatorBank& bank, NoiseBank& noiseBank,
+               ModulationEngine& modulationEngine)
+        : voiceIndex(index), spatialState(spatial), oscillators(bank), noise(noiseBank), modulation(modulationEngine)
     {
         adsrParams.attack = 0.02f;
         adsrParams.decay = 0.1f;
@@ -29,32 +36,37 @@ public:
     void controllerMoved(int controllerNumber, int newControllerValue) override;
     void pitchWheelMoved(int newPitchWheelValue) override;
     
-    void updateParams(const juce::AudioProcessorValueTreeState& apvts);
+    using Parameters = SynthParameters<float>;
 
-    void prepareToPlay(double sampleRate, int samplesPerBlock, int outputChannels);
+    // Binds the voice to the parameters it reads, called once after the registry exists
+    void updateParams(const Parameters& registry, Parameters::Handle gainHandle);
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock);
+
+    // Hands this voice's pitch sweep for the sub-block to the banks, which render it before renderNextBlock
+    void updateOscillator(int startSample, int numSamples);
     void renderNextBlock(juce::AudioBuffer< float >& outputBuffer, int startSample, int numSamples) override;
 
+    int getVoiceIndex() const noexcept { return voiceIndex; }
+
+    // How long a note keeps sounding after its note off
+    float getReleaseSeconds() const noexcept { return adsrParams.release; }
+
 private:
+    // Slot of this voice in the pool's spatial state. The voice renders mono into
+    // that slot and the processor places it in the stereo field.
+    const int voiceIndex;
+    SpatialVoiceState& spatialState;
+    WavetableOscillatorBank& oscillators;   // this voice's oscillator is lane voiceIndex
+    NoiseBank& noise;                       // played instead while it's enabled
+    ModulationEngine& modulation;           // and so is its LFO
+
     juce::ADSR adsr;
     juce::ADSR::Parameters adsrParams;
     juce::AudioBuffer<float> synthBuffer;
 
-    std::atomic<float>* lfoSpeed = nullptr;
-    std::atomic<float>* minFreq = nullptr;
-    std::atomic<float>* maxFreq = nullptr;
-    std::atomic<float>* zDepth = nullptr;
-
-    juce::dsp::Oscillator<float> osc{ [](float x) { return std::sin(x); } };
-    // return std::sin(x); } };                           Sin wave oscillator
-    // return x < 0.0f ? -1.0f : 1.0f; } };               Square wave oscillator
-    // return x / juce::MathConstants<float>::pi; } };    Saw wave oscillator
-    juce::dsp::Gain<float> gain;
-
-
-    float lfoPhase = 0.0f;
-    float squarePhase = 0.0f;
-    double currentSampleRate = 44100.0;
-    const float lfoFreq = 115.5f;
+    const Parameters* params = nullptr;
+    Parameters::Handle zDepth;
 
     bool isPrepared{ false };
 };
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    TapSynthesiser.cpp
+    Created: 17 Oct 2026 7:48:19pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "TapSynthesiser.h"
+
+TapSynthesiser::TapSynthesiser(WavetableOscillatorBank& oscillatorBank, NoiseBank& noiseBank)
+    : oscillators(oscillatorBank), noise(noiseBank)
+{
+}
+
+SynthVoice* TapSynthesiser::addSynthVoice(SynthVoice* voice)
+{
+    addVoice(voice);
+    voices.add(voice);
+    activeVoices.resize((size_t)voices.size());
+    return voice;
+}
+
+void TapSynthesiser::renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    int numActive = 0;
+
+    for (auto* voice : voices)
+    {
+        if (!voice->isVoiceActive())
+            continue;
+
+        voice->updateOscillator(startSample, numSamples);
+        activeVoices[(size_t)numActive++] = voice->getVoiceIndex();
+    }
+
+    // One slice of whole SIMD groups per thread, the lanes of a group don't affect each other
+    constexpr int lanes = (int)juce::dsp::SIMDRegister<float>::size();
+    const int numGroups = (numActive + lanes - 1) / lanes;
+    const int numSlices = workerPool != nullptr ? juce::jmin(workerPool->getNumThreads(), numGroups) : 1;
+
+    if (numSlices > 1)
+    {
+        const int voicesPerSlice = (numGroups + numSlices - 1) / numSlices * lanes;
+
+        auto renderSlice = [this, numActive, voicesPerSlice, startSample, numSamples](int slice, int)
+        {
+            const int first = slice * voicesPerSlice;
+            const int count = juce::jmin(voicesPerSlice, numActive - first);
+
+            if (count > 0)
+                renderSources(activeVoices.data() + first, count, startSample, numSamples);
+        };
+
+        workerPool->run(numSlices, renderSlice);
+    }
+    else
+    {
+        renderSources(activeVoices.data(), numActive, startSample, numSamples);
+    }
+
+    juce::Synthesiser::renderVoices(outputAudio, startSample, numSamples);
+}
+
+void TapSynthesiser::renderSources(const int* voiceIndices, int numVoicesToRender, int startSample, int numSamples) noexcept
+{
+    if (noise.isEnabled())
+        noise.render(voiceIndices, numVoicesToRender, startSample, numSamples);
+    else
+        oscillators.render(voiceIndices, numVoicesToRender, startSample, numSamples);
+}
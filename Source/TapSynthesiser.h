@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    TapSynthesiser.h
+    Created: 17 Oct 2026 7:48:19pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SynthVoice.h"
+#include "WavetableOscillator.h"
+#include "NoiseBank.h"
+#include "RealtimeWorkerPool.h"
+
+// juce::Synthesiser that renders the oscillators, or the noise, of every active voice
+// together in its bank, a SIMD register of voices at a time. That happens after each
+// voice's pitch sweep and before the voices run their own envelopes and gains.
+// Sub-blocks split at MIDI events get the same treatment, so notes still start
+// sample-accurately. With a worker pool the bank's groups are split between its
+// threads; every voice comes out the same either way.
+class TapSynthesiser : public juce::Synthesiser
+{
+public:
+    TapSynthesiser(WavetableOscillatorBank& oscillatorBank, NoiseBank& noiseBank);
+
+    // Adds the voice to the synth and keeps a typed pointer to it
+    SynthVoice* addSynthVoice(SynthVoice* voice);
+    const juce::Array<SynthVoice*>& getSynthVoices() const noexcept { return voices; }
+
+    // nullptr renders on the audio thread alone. The pool has to outlive us.
+    void setWorkerPool(RealtimeWorkerPool* pool) noexcept { workerPool = pool; }
+
+protected:
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+    using juce::Synthesiser::renderVoices;
+
+private:
+    // Whichever bank the voices are playing
+    void renderSources(const int* voiceIndices, int numVoicesToRender, int startSample, int numSamples) noexcept;
+
+    WavetableOscillatorBank& oscillators;
+    NoiseBank& noise;
+    RealtimeWorkerPool* workerPool = nullptr;
+    juce::Array<SynthVoice*> voices;
+    std::vector<int> activeVoices;      // sized when voices are added, never on the audio thread
+};
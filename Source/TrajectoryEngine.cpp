@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+
+    TrajectoryEngine.cpp
+    Created: 17 Oct 2026 5:37:46pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "TrajectoryEngine.h"
+
+namespace
+{
+    using Vec = juce::dsp::SIMDRegister<float>;
+    constexpr int vecSize = (int)Vec::size();
+
+    template <typename Function>
+    void fillPath(TrajectoryEngine::Path& path, Function&& pointAt)
+    {
+        for (int i = 0; i < TrajectoryEngine::tableSize; ++i)
+        {
+            const auto point = pointAt(juce::MathConstants<float>::twoPi * (float)i / (float)TrajectoryEngine::tableSize);
+            path.x[(size_t)i] = point.x;
+            path.y[(size_t)i] = point.y;
+        }
+
+        path.x.back() = path.x.front();
+        path.y.back() = path.y.front();
+    }
+}
+
+TrajectoryEngine::TrajectoryEngine(int numVoices)
+{
+    // Everything starts in front of the listener and goes round clockwise
+    fillPath(circle, [](float t) { return juce::Point<float>(std::sin(t), std::cos(t)); });
+    fillPath(ellipse, [](float t) { return juce::Point<float>(std::sin(t), 0.5f * std::cos(t)); });
+    fillPath(figureEight, [](float t) { return juce::Point<float>(std::sin(2.0f * t), std::cos(t)); });
+
+    // A fixed random walk, closed by the spline so it loops without a jump
+    juce::Random random(0x5eed);
+    std::array<juce::Point<float>, 12> walk;
+    juce::Point<float> step;
+
+    for (auto& point : walk)
+    {
+        step.x = juce::jlimit(-1.0f, 1.0f, step.x + (random.nextFloat() - 0.5f) * 1.2f);
+        step.y = juce::jlimit(-1.0f, 1.0f, step.y + (random.nextFloat() - 0.5f) * 1.2f);
+        point = step;
+    }
+
+    buildSpline(walk.data(), (int)walk.size(), randomWalk);
+
+    setSplinePoints(nullptr, 0);
+    splineExchange.update();
+
+    // Golden ratio spacing keeps any number of voices spread along the loop
+    offsets.resize((size_t)numVoices);
+    for (int v = 0; v < numVoices; ++v)
+    {
+        const double offset = v * 0.6180339887498949;
+        offsets[(size_t)v] = offset - std::floor(offset);
+    }
+}
+
+void TrajectoryEngine::prepare(double sampleRate, int maxBlockSize)
+{
+    inverseSampleRate = 1.0 / sampleRate;
+
+    maxSamples = maxBlockSize;
+
+    reset();
+}
+
+void TrajectoryEngine::reset()
+{
+    position = 0.0;
+}
+
+void TrajectoryEngine::buildSpline(const juce::Point<float>* points, int numPoints, Path& dest) noexcept
+{
+    // Until someone draws one the spline is a rounded diamond
+    static const juce::Point<float> diamond[] = { { 0.0f, 1.0f }, { 0.8f, 0.0f }, { 0.0f, -0.6f }, { -0.8f, 0.0f } };
+
+    if (numPoints <= 0 || points == nullptr)
+    {
+        points = diamond;
+        numPoints = 4;
+    }
+
+    numPoints = juce::jmin(numPoints, maxSplinePoints);
+
+    if (numPoints == 1)
+    {
+        const auto point = points[0];
+        dest.x.fill(point.x);
+        dest.y.fill(point.y);
+        return;
+    }
+
+    // Closed uniform Catmull-Rom, the same number of table points per segment
+    auto at = [&](int index) { return points[(index % numPoints + numPoints) % numPoints]; };
+
+    for (int i = 0; i < tableSize; ++i)
+    {
+        const float t = (float)i * (float)numPoints / (float)tableSize;
+        const int segment = (int)t;
+        const float u = t - (float)segment;
+
+        const auto p0 = at(segment - 1), p1 = at(segment), p2 = at(segment + 1), p3 = at(segment + 2);
+
+        auto curve = [u](float a, float b, float c, float d)
+        {
+            return 0.5f * (2.0f * b + (c - a) * u + (2.0f * a - 5.0f * b + 4.0f * c - d) * u * u
+                           + (3.0f * b - a - 3.0f * c + d) * u * u * u);
+        };
+
+        dest.x[(size_t)i] = curve(p0.x, p1.x, p2.x, p3.x);
+        dest.y[(size_t)i] = curve(p0.y, p1.y, p2.y, p3.y);
+    }
+
+    dest.x.back() = dest.x.front();
+    dest.y.back() = dest.y.front();
+}
+
+void TrajectoryEngine::setSplinePoints(const juce::Point<float>* points, int numPoints)
+{
+    buildSpline(points, numPoints, splineExchange.getWriteBuffer());
+    splineExchange.publish();
+}
+
+void TrajectoryEngine::setSplinePath(const Path& path)
+{
+    splineExchange.getWriteBuffer() = path;
+    splineExchange.publish();
+}
+
+void TrajectoryEngine::setParameters(Shape newShape, float newSize, double cyclesPerSecond) noexcept
+{
+    splineExchange.update();
+
+    shape = newShape;
+    size = juce::jmax(0.0f, newSize);
+    increment = cyclesPerSecond * inverseSampleRate;
+}
+
+void TrajectoryEngine::syncPosition(double cyclePosition) noexcept
+{
+    position = cyclePosition - std::floor(cyclePosition);
+}
+
+const TrajectoryEngine::Path& TrajectoryEngine::getPath() const noexcept
+{
+    switch (shape)
+    {
+        case Shape::ellipse:     return ellipse;
+        case Shape::figureEight: return figureEight;
+        case Shape::spline:      return splineExchange.getReadBuffer();
+        case Shape::randomWalk:  return randomWalk;
+        case Shape::circle:
+        case Shape::off:
+        default:                 return circle;
+    }
+}
+
+void TrajectoryEngine::render(int voiceIndex, float centreX, float centreY, int numSamples, float* renderX, float* renderY) const noexcept
+{
+    jassert(numSamples > 0 && numSamples <= maxSamples);
+
+    const auto& path = getPath();
+    const double start = position + offsets[(size_t)voiceIndex];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Wrapped in double so the phase stays exact over long runs, the table read is float
+        double phase = start + increment * (double)i;
+        phase -= std::floor(phase);
+
+        const float index = (float)(phase * tableSize);
+        const int i0 = juce::jmin((int)index, tableSize - 1);
+        const float frac = index - (float)i0;
+
+        const float x = path.x[(size_t)i0] + frac * (path.x[(size_t)i0 + 1] - path.x[(size_t)i0]);
+        const float y = path.y[(size_t)i0] + frac * (path.y[(size_t)i0 + 1] - path.y[(size_t)i0]);
+
+        renderX[i] = juce::jlimit(1.0f, 100.0f, centreX + size * x);
+        renderY[i] = juce::jlimit(1.0f, 100.0f, centreY + size * y);
+    }
+
+    const int padded = (numSamples + vecSize - 1) / vecSize * vecSize;
+    std::fill(renderX + numSamples, renderX + padded, renderX[numSamples - 1]);
+    std::fill(renderY + numSamples, renderY + padded, renderY[numSamples - 1]);
+}
+
+void TrajectoryEngine::advance(int numSamples) noexcept
+{
+    position += increment * (double)numSamples;
+    position -= std::floor(position);
+}
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    TrajectoryEngine.h
+    Created: 17 Oct 2026 5:37:46pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "TripleBuffer.h"
+
+// Built-in motion paths for the sources, so they can move without any host automation.
+// Every path is a closed loop precomputed into a lookup table of offsets in -1..1,
+// and each sample of a block reads its own position from it, so motion is smooth
+// at any speed and costs an interpolated table read per sample per source.
+//
+// All voices share one clock (free running, or locked to the host's beat) and
+// each is offset along the path, so many sources spread out along the same loop.
+class TrajectoryEngine
+{
+public:
+    enum class Shape
+    {
+        off = 0,
+        circle,
+        ellipse,
+        figureEight,
+        spline,         // Catmull-Rom through the points given to setSplinePoints()
+        randomWalk
+    };
+
+    static constexpr int tableSize = 1024;
+    static constexpr int maxSplinePoints = 16;
+
+    // One loop, tableSize points plus a copy of the first one for the interpolation
+    struct Path
+    {
+        std::array<float, tableSize + 1> x {};
+        std::array<float, tableSize + 1> y {};
+    };
+
+    explicit TrajectoryEngine(int numVoices);
+
+    void prepare(double sampleRate, int maxBlockSize);
+    void reset();
+
+    // One writer thread at a time. The spline's control points in -1..1, no points
+    // is the default loop; the new table reaches the audio thread as a whole at its
+    // next setParameters(). setSplinePath() takes a table built with buildSpline().
+    void setSplinePoints(const juce::Point<float>* points, int numPoints);
+    void setSplinePath(const Path& path);
+
+    // Closed Catmull-Rom loop through up to maxSplinePoints points, safe on any thread
+    static void buildSpline(const juce::Point<float>* points, int numPoints, Path& dest) noexcept;
+
+    // Audio thread, once per block. size is the path's radius in box units.
+    void setParameters(Shape newShape, float newSize, double cyclesPerSecond) noexcept;
+
+    // Locks the clock to the host, cyclePosition is where the path is at the block's start
+    void syncPosition(double cyclePosition) noexcept;
+
+    bool isMoving() const noexcept { return shape != Shape::off && size > 0.0f; }
+
+    // Positions of one voice for every sample of the block, around (centreX, centreY)
+    // and kept inside the box. x and y are SIMD aligned with room for numSamples padded
+    // to whole registers, the padding repeats the last position. Voices can be rendered
+    // on different threads at once, each into its own arrays.
+    void render(int voiceIndex, float centreX, float centreY, int numSamples, float* x, float* y) const noexcept;
+
+    // Moves the shared clock on once every voice has been rendered
+    void advance(int numSamples) noexcept;
+
+private:
+    const Path& getPath() const noexcept;
+
+    Path circle, ellipse, figureEight, randomWalk;
+    TripleBuffer<Path> splineExchange;          // message thread to audio thread
+
+    std::vector<double> offsets;                // cycles, one per voice
+    double position = 0.0;                      // cycles at the start of the block
+    double increment = 0.0;                     // cycles per sample
+    double inverseSampleRate = 1.0 / 44100.0;
+
+    Shape shape = Shape::off;
+    float size = 0.0f;
+
+    int maxSamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(TrajectoryEngine)
+};
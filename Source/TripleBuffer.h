@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    TripleBuffer.h
+    Created: 17 Oct 2026 4:02:18pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Wait-free hand-over of whole values from one writer thread to one reader thread.
+// The writer fills its back buffer and publishes it, the reader picks up the most
+// recently published one. Neither side ever waits for the other and each only
+// touches a buffer nobody else owns, so the reader never sees a half written value;
+// values published in between two reads are simply skipped.
+template <typename ValueType>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+
+    // Writer side. The returned buffer holds whatever was in it the last time round,
+    // not the last published value, so fill all of it before publishing.
+    ValueType& getWriteBuffer() noexcept { return buffers[writeIndex]; }
+
+    void publish() noexcept
+    {
+        const auto previous = middle.exchange((juce::uint8)(writeIndex | freshBit), std::memory_order_acq_rel);
+        writeIndex = previous & indexMask;
+    }
+
+    // Reader side. Returns true and swaps in the latest value if anything was published
+    // since the last call, otherwise the read buffer stays as it was.
+    bool update() noexcept
+    {
+        if ((middle.load(std::memory_order_relaxed) & freshBit) == 0)
+            return false;
+
+        const auto previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & indexMask;
+        return true;
+    }
+
+    const ValueType& getReadBuffer() const noexcept { return buffers[readIndex]; }
+
+private:
+    static constexpr juce::uint8 indexMask = 3;
+    static constexpr juce::uint8 freshBit = 4;
+
+    ValueType buffers[3] {};
+    std::atomic<juce::uint8> middle { 1 };  // the buffer in between, plus whether it's unread
+    juce::uint8 writeIndex = 0;             // only touched by the writer
+    juce::uint8 readIndex = 2;              // only touched by the reader
+
+    static_assert(std::atomic<juce::uint8>::is_always_lock_free, "the exchange has to be lock-free");
+
+    JUCE_DECLARE_NON_COPYABLE(TripleBuffer)
+};
@@ -0,0 +1,185 @@
+/*
+  ==============================================================================
+
+    WavetableOscillator.cpp
+    Created: 17 Oct 2026 7:10:36pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include "WavetableOscillator.h"
+
+namespace
+{
+    // Fourier series amplitude of harmonic k (sine terms)
+    float getHarmonic(WavetableSet::Waveform waveform, int k) noexcept
+    {
+        const float pi = juce::MathConstants<float>::pi;
+
+        switch (waveform)
+        {
+            case WavetableSet::Waveform::sine:      return k == 1 ? 1.0f : 0.0f;
+            case WavetableSet::Waveform::square:    return (k % 2) != 0 ? 4.0f / (pi * (float)k) : 0.0f;
+            case WavetableSet::Waveform::saw:       return ((k % 2) != 0 ? 2.0f : -2.0f) / (pi * (float)k);
+            case WavetableSet::Waveform::triangle:  return (k % 2) != 0 ? (((k / 2) % 2) != 0 ? -8.0f : 8.0f) / (pi * pi * (float)(k * k)) : 0.0f;
+        }
+
+        return 0.0f;
+    }
+}
+
+std::shared_ptr<const WavetableSet> WavetableSet::getShared()
+{
+    static std::shared_ptr<const WavetableSet> shared(new WavetableSet());
+    return shared;
+}
+
+WavetableSet::WavetableSet()
+{
+    constexpr int order = 11;
+    static_assert((1 << order) == tableSize, "The inverse FFT builds one whole table");
+
+    juce::dsp::FFT fft(order);
+    std::vector<float> spectrum((size_t)(2 * tableSize));
+    tables.allocate((size_t)(numWaveforms * numLevels * (tableSize + 1)), true);
+
+    for (int w = 0; w < numWaveforms; ++w)
+    {
+        const auto shape = (Waveform)w;
+        float normalisation = 1.0f;
+
+        for (int level = 0; level < numLevels; ++level)
+        {
+            // Sine terms: bin k gets -k/2 * amplitude on the imaginary part, the
+            // inverse transform divides by the size
+            std::fill(spectrum.begin(), spectrum.end(), 0.0f);
+            const int harmonics = juce::jmax(1, maxHarmonics >> level);
+
+            for (int k = 1; k <= harmonics; ++k)
+                spectrum[(size_t)(2 * k + 1)] = -0.5f * (float)tableSize * getHarmonic(shape, k);
+
+            fft.performRealOnlyInverseTransform(spectrum.data());
+
+            auto* table = const_cast<float*>(getTable(shape, level));
+            std::copy(spectrum.begin(), spectrum.begin() + tableSize, table);
+            table[tableSize] = table[0];
+
+            // The richest level sets the scale for all of them, so switching levels
+            // doesn't change the loudness
+            if (level == 0)
+            {
+                float peak = 0.0f;
+                for (int i = 0; i < tableSize; ++i)
+                    peak = juce::jmax(peak, std::abs(table[i]));
+                normalisation = peak > 0.0f ? 1.0f / peak : 1.0f;
+            }
+
+            juce::FloatVectorOperations::multiply(table, normalisation, tableSize + 1);
+        }
+    }
+}
+
+int WavetableSet::getLevel(float increment) noexcept
+{
+    // Highest harmonic that fits: Nyquist is half a cycle per sample
+    const float allowed = 0.5f / juce::jmax(increment, 1.0e-9f);
+
+    for (int level = 0; level < numLevels - 1; ++level)
+        if ((float)(maxHarmonics >> level) <= allowed)
+            return level;
+
+    return numLevels - 1;
+}
+
+//==============================================================================
+WavetableOscillatorBank::WavetableOscillatorBank(int numVoices)
+    : wavetables(WavetableSet::getShared())
+{
+    phase.assign((size_t)numVoices, 0.0f);
+}
+
+void WavetableOscillatorBank::prepare(double sampleRate, int maxBlockSize)
+{
+    inverseSampleRate = (float)(1.0 / sampleRate);
+    increments.setSize((int)phase.size(), maxBlockSize);
+    increments.clear();
+    output.setSize((int)phase.size(), maxBlockSize);
+    output.clear();
+}
+
+void WavetableOscillatorBank::setFrequencies(int voiceIndex, const float* frequencies, int startSample, int numSamples) noexcept
+{
+    auto* dest = increments.getWritePointer(voiceIndex, startSample);
+    juce::FloatVectorOperations::copyWithMultiply(dest, frequencies + startSample, inverseSampleRate, numSamples);
+    juce::FloatVectorOperations::clip(dest, dest, 0.0f, 0.5f, numSamples);
+}
+
+void WavetableOscillatorBank::render(const int* voiceIndices, int numVoicesToRender, int startSample, int numSamples) noexcept
+{
+    using Vec = juce::dsp::SIMDRegister<float>;
+    constexpr int lanes = (int)Vec::size();
+
+    alignas(Vec::SIMDRegisterSize) float phaseLanes[lanes];
+    alignas(Vec::SIMDRegisterSize) float incrementLanes[lanes];
+    const float* incrementSources[lanes];
+    alignas(Vec::SIMDRegisterSize) float positionLanes[lanes];
+    alignas(Vec::SIMDRegisterSize) float sampleLanes[lanes];
+    alignas(Vec::SIMDRegisterSize) float slopeLanes[lanes];
+    alignas(Vec::SIMDRegisterSize) float fractionLanes[lanes];
+    alignas(Vec::SIMDRegisterSize) float outputLanes[lanes];
+    const float* tableLanes[lanes];
+    float* destLanes[lanes];
+
+    const auto one = Vec::expand(1.0f);
+    const auto size = Vec::expand((float)WavetableSet::tableSize);
+
+    for (int first = 0; first < numVoicesToRender; first += lanes)
+    {
+        const int count = juce::jmin(lanes, numVoicesToRender - first);
+
+        // Gather the group into lanes, spare lanes duplicate a real voice and are dropped.
+        // The mip level is picked for the highest frequency in the sub-block.
+        for (int l = 0; l < lanes; ++l)
+        {
+            const int v = voiceIndices[first + juce::jmin(l, count - 1)];
+            phaseLanes[l] = phase[(size_t)v];
+            incrementSources[l] = increments.getReadPointer(v, startSample);
+            tableLanes[l] = wavetables->getTable(waveform,
+                WavetableSet::getLevel(juce::FloatVectorOperations::findMaximum(incrementSources[l], numSamples)));
+            destLanes[l] = output.getWritePointer(v, startSample);
+        }
+
+        auto phases = Vec::fromRawArray(phaseLanes);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            (phases * size).copyToRawArray(positionLanes);
+
+            // SIMDRegister has no gather, the table and increment reads are the only scalar part
+            for (int l = 0; l < lanes; ++l)
+            {
+                const int index = (int)positionLanes[l];
+                const float* t = tableLanes[l] + index;
+                sampleLanes[l] = t[0];
+                slopeLanes[l] = t[1] - t[0];
+                fractionLanes[l] = positionLanes[l] - (float)index;
+                incrementLanes[l] = incrementSources[l][i];
+            }
+
+            (Vec::fromRawArray(sampleLanes) + Vec::fromRawArray(fractionLanes) * Vec::fromRawArray(slopeLanes))
+                .copyToRawArray(outputLanes);
+
+            for (int l = 0; l < count; ++l)
+                destLanes[l][i] = outputLanes[l];
+
+            phases += Vec::fromRawArray(incrementLanes);
+            phases -= one & Vec::greaterThanOrEqual(phases, one);
+        }
+
+        phases.copyToRawArray(phaseLanes);
+
+        for (int l = 0; l < count; ++l)
+            phase[(size_t)voiceIndices[first + l]] = phaseLanes[l];
+    }
+}
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    WavetableOscillator.h
+    Created: 17 Oct 2026 7:10:36pm
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+
+// Band-limited single-cycle tables, one mip level per octave: level k holds
+// maxHarmonics >> k harmonics, so picking the level by frequency keeps every
+// harmonic under Nyquist. The tables don't depend on the sample rate and are built
+// once per process, every oscillator bank shares them.
+class WavetableSet
+{
+public:
+    enum class Waveform
+    {
+        sine = 0,
+        square,
+        saw,
+        triangle
+    };
+
+    static constexpr int numWaveforms = 4;
+    static constexpr int tableSize = 2048;
+    static constexpr int numLevels = 11;
+    static constexpr int maxHarmonics = tableSize / 2 - 1;
+
+    static std::shared_ptr<const WavetableSet> getShared();
+
+    // tableSize + 1 samples, the last one repeats the first so interpolation never wraps
+    const float* getTable(Waveform waveform, int level) const noexcept
+    {
+        return tables.get() + ((size_t)waveform * numLevels + (size_t)level) * (tableSize + 1);
+    }
+
+    // Richest level whose harmonics all stay below Nyquist at this phase increment
+    static int getLevel(float increment) noexcept;
+
+private:
+    WavetableSet();
+
+    juce::HeapBlock<float> tables;
+
+    JUCE_DECLARE_NON_COPYABLE(WavetableSet)
+};
+
+//==============================================================================
+// Phase accumulators of every voice in the pool, kept as structure-of-arrays so the
+// active voices can be rendered a SIMD register's worth at a time: each lane of a
+// juce::dsp::SIMDRegister is one voice. Frequencies are per sample, so modulation
+// glides smoothly through a block.
+class WavetableOscillatorBank
+{
+public:
+    using Waveform = WavetableSet::Waveform;
+
+    explicit WavetableOscillatorBank(int numVoices);
+
+    void prepare(double sampleRate, int maxBlockSize);
+
+    void setWaveform(Waveform newWaveform) noexcept { waveform = newWaveform; }
+    // Frequencies in Hz for samples [startSample, startSample + numSamples), indexed like the host buffer
+    void setFrequencies(int voiceIndex, const float* frequencies, int startSample, int numSamples) noexcept;
+    void resetPhase(int voiceIndex) noexcept { phase[(size_t)voiceIndex] = 0.0f; }
+
+    // Renders samples [startSample, startSample + numSamples) of the given voices
+    void render(const int* voiceIndices, int numVoicesToRender, int startSample, int numSamples) noexcept;
+
+    // The block rendered for one voice, indexed like the host buffer
+    const float* getOutput(int voiceIndex) const noexcept { return output.getReadPointer(voiceIndex); }
+
+private:
+    std::shared_ptr<const WavetableSet> wavetables;
+    Waveform waveform = Waveform::sine;
+    float inverseSampleRate = 1.0f / 44100.0f;
+
+    std::vector<float> phase;               // cycles, one entry per voice
+    juce::AudioBuffer<float> increments;    // cycles per sample, one channel per voice
+    juce::AudioBuffer<float> output;        // one channel per voice
+
+    JUCE_DECLARE_NON_COPYABLE(WavetableOscillatorBank)
+};
@@ -0,0 +1,170 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 17 Oct 2026 6:21:05pm
+    Author:  Carlos
+
+    Headless render benchmark. Instantiates the processor without an editor and
+    renders a few seconds for every combination of sample rate, block size and
+    voice count, timing each processBlock call. Prints one JSON array to stdout.
+    Built with BINAURAL_RAYS_PROFILING on, every entry also has the processor's
+    own per stage profile of the timed blocks.
+
+        BinauralRaysBench [--seconds=10] [--rates=44100,48000,96000]
+                          [--blocks=32,64,128,256,512] [--voices=16,32,64,128,256,512]
+                          [--oversampling=1,2,4,8] [--threads=1,2,4,8] [--hrtf=<file.brht>]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <chrono>
+#include <iostream>
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    juce::Array<int> parseList(const juce::ArgumentList& args, const char* option, const char* fallback)
+    {
+        auto text = args.getValueForOption(option);
+        if (text.isEmpty())
+            text = fallback;
+
+        juce::Array<int> values;
+        for (const auto& token : juce::StringArray::fromTokens(text, ",", {}))
+            if (token.getIntValue() > 0)
+                values.add(token.getIntValue());
+
+        return values;
+    }
+
+    double percentile(const std::vector<double>& sorted, double fraction)
+    {
+        const auto index = (size_t)std::ceil(fraction * (double)sorted.size()) - 1;
+        return sorted[juce::jmin(index, sorted.size() - 1)];
+    }
+
+    void setChoice(TapSynthAudioProcessor& processor, const char* parameterID, int index)
+    {
+        if (auto* parameter = processor.getState().getParameter(parameterID))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1((float)index));
+    }
+
+    juce::var run(double sampleRate, int blockSize, int numVoices, int oversampling, int threads, double seconds, const juce::File& hrtfFile)
+    {
+        TapSynthAudioProcessor processor(numVoices);
+
+        if (hrtfFile != juce::File())
+            processor.setHrtfFile(hrtfFile);
+
+        // Set before prepareToPlay, so they're in place from the first block
+        setChoice(processor, "oversampling", juce::roundToInt(std::log2(oversampling)));
+        setChoice(processor, "renderThreads", juce::roundToInt(std::log2(threads)));
+
+        processor.setPlayConfigDetails(0, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+
+        // One held note per voice, each on its own note/channel pair so none steals another.
+        // They start above the sequencer's note, which keeps playing on top.
+        juce::MidiBuffer notes;
+        for (int v = 0; v < numVoices; ++v)
+            notes.addEvent(juce::MidiMessage::noteOn(1 + v / 96, 30 + v % 96, 0.5f), 0);
+
+        const int numBlocks = juce::jmax(1, (int)(seconds * sampleRate / blockSize));
+        const int warmupBlocks = juce::jmax(1, numBlocks / 20);
+        std::vector<double> blockNanos;
+        blockNanos.reserve((size_t)numBlocks);
+
+        using Clock = std::chrono::steady_clock;
+        double totalNanos = 0.0;
+
+        for (int b = 0; b < warmupBlocks + numBlocks; ++b)
+        {
+            buffer.clear();
+            midi.clear();
+
+            if (b == 0)
+                midi.swapWith(notes);
+
+            if (b == warmupBlocks)
+                processor.getProfiler().reset();
+
+            const auto start = Clock::now();
+            processor.processBlock(buffer, midi);
+            const auto nanos = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+            if (b >= warmupBlocks)
+            {
+                blockNanos.push_back(nanos);
+                totalNanos += nanos;
+            }
+        }
+
+        const auto profile = processor.getProfiler().getSnapshot();
+        processor.releaseResources();
+
+        std::sort(blockNanos.begin(), blockNanos.end());
+
+        const double renderedSamples = (double)numBlocks * blockSize;
+        const double blockBudget = 1.0e9 * blockSize / sampleRate;
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty("sampleRate", sampleRate);
+        result->setProperty("blockSize", blockSize);
+        result->setProperty("voices", numVoices);
+        result->setProperty("oversampling", oversampling);
+        result->setProperty("threads", threads);
+        result->setProperty("latencySamples", processor.getLatencySamples());
+        result->setProperty("seconds", renderedSamples / sampleRate);
+        result->setProperty("realtimeFactor", renderedSamples / sampleRate * 1.0e9 / totalNanos);
+        result->setProperty("nsPerSample", totalNanos / renderedSamples);
+        result->setProperty("blockMedianUs", percentile(blockNanos, 0.5) / 1000.0);
+        result->setProperty("blockP99Us", percentile(blockNanos, 0.99) / 1000.0);
+        result->setProperty("blockMaxUs", blockNanos.back() / 1000.0);
+        result->setProperty("blockBudgetUs", blockBudget / 1000.0);
+
+        if (DspProfiler::isEnabled())
+            result->setProperty("profile", profile.toVar());
+
+        return juce::var(result);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // The parameter tree runs a timer, which needs a message manager
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    const auto secondsText = args.getValueForOption("--seconds");
+    const double seconds = secondsText.isNotEmpty() ? secondsText.getDoubleValue() : 10.0;
+    const auto rates = parseList(args, "--rates", "44100,48000,96000");
+    const auto blocks = parseList(args, "--blocks", "32,64,128,256,512");
+    const auto voiceCounts = parseList(args, "--voices", "16,32,64,128,256,512");
+    const auto oversamplingFactors = parseList(args, "--oversampling", "1");
+    const auto threadCounts = parseList(args, "--threads", "1");
+
+    const auto hrtfPath = args.getValueForOption("--hrtf");
+    const auto hrtfFile = hrtfPath.isNotEmpty() ? juce::File::getCurrentWorkingDirectory().getChildFile(hrtfPath) : juce::File();
+
+    juce::Array<juce::var> results;
+
+    for (int rate : rates)
+        for (int block : blocks)
+            for (int voices : voiceCounts)
+                for (int factor : oversamplingFactors)
+                    for (int threads : threadCounts)
+                    {
+                        results.add(run(rate, block, voices, juce::nextPowerOfTwo(juce::jlimit(1, 8, factor)),
+                                        juce::nextPowerOfTwo(juce::jlimit(1, 8, threads)), seconds, hrtfFile));
+                        std::cerr << "." << std::flush;
+                    }
+
+    std::cerr << "\n";
+    std::cout << juce::JSON::toString(juce::var(results)) << std::endl;
+    return 0;
+}
@@ -0,0 +1,216 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 17 Oct 2026 5:40:12pm
+    Author:  Carlos
+
+    Offline HRTF preprocessor: turns a directory of stereo HRIR WAVs into the
+    memory-mapped set HrtfDatabase loads.
+
+        HrtfBuilder <wav directory> <output.brht> [--rate=48000] [--length=256]
+                    [--az-step=5] [--el-min=-40] [--el-max=90] [--el-step=10]
+
+    Every file is one measured direction, left ear on channel 0, named with its
+    direction in degrees like "az135_el-20.wav" (azimuth clockwise from straight
+    ahead). SOFA sets need exporting to WAVs like that first, reading them directly
+    would pull in HDF5.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include <regex>
+#include "../../Source/HrtfDatabase.h"
+#include "../../Source/HrtfSet.h"
+
+namespace
+{
+    struct Measurement
+    {
+        float azimuth = 0.0f, elevation = 0.0f;     // degrees
+        juce::AudioBuffer<float> impulse;           // both ears, onsets aligned
+    };
+
+    juce::Vector3D<float> toUnitVector(float azimuth, float elevation)
+    {
+        const float az = juce::degreesToRadians(azimuth), el = juce::degreesToRadians(elevation);
+        return { std::cos(el) * std::sin(az), std::cos(el) * std::cos(az), std::sin(el) };
+    }
+
+    // Drops everything before the onset, so the ITD stays with the plugin's delay
+    // lines and neighbouring directions can be blended without comb filtering
+    void alignOnset(const float* source, int sourceLength, float* dest, int length)
+    {
+        int peak = 0;
+        for (int i = 1; i < sourceLength; ++i)
+            if (std::abs(source[i]) > std::abs(source[peak]))
+                peak = i;
+
+        const float threshold = std::abs(source[peak]) * 0.1f;
+        int onset = 0;
+        while (onset < peak && std::abs(source[onset]) < threshold)
+            ++onset;
+
+        const int start = juce::jmax(0, onset - 2);
+        const int toCopy = juce::jlimit(0, length, sourceLength - start);
+
+        std::fill(dest, dest + length, 0.0f);
+        std::copy(source + start, source + start + toCopy, dest);
+    }
+
+    bool readMeasurement(juce::AudioFormatManager& formats, const juce::File& file, double sampleRate, int length, Measurement& result)
+    {
+        static const std::regex pattern(R"(az(-?\d+(?:\.\d+)?)_el(-?\d+(?:\.\d+)?))");
+        std::smatch match;
+        const auto name = file.getFileNameWithoutExtension().toStdString();
+
+        if (!std::regex_search(name, match, pattern))
+            return false;
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+
+        if (reader == nullptr || reader->numChannels < 2)
+            return false;
+
+        // A little zero padding, the interpolator reads a few samples ahead
+        const int rawLength = (int)reader->lengthInSamples;
+        juce::AudioBuffer<float> raw(2, rawLength + 8);
+        raw.clear();
+        reader->read(&raw, 0, rawLength, 0, true, true);
+
+        // Resample to the rate the set is built for
+        const double ratio = reader->sampleRate / sampleRate;
+        const int resampledLength = (int)std::ceil(rawLength / ratio);
+        juce::AudioBuffer<float> resampled(2, resampledLength);
+
+        for (int ear = 0; ear < 2; ++ear)
+        {
+            juce::LagrangeInterpolator interpolator;
+            interpolator.process(ratio, raw.getReadPointer(ear), resampled.getWritePointer(ear), resampledLength);
+        }
+
+        result.azimuth = std::stof(match[1].str());
+        result.elevation = std::stof(match[2].str());
+        result.impulse.setSize(2, length);
+
+        for (int ear = 0; ear < 2; ++ear)
+            alignOnset(resampled.getReadPointer(ear), resampledLength, result.impulse.getWritePointer(ear), length);
+
+        return true;
+    }
+
+    const Measurement& findNearest(const std::vector<Measurement>& measurements, float azimuth, float elevation)
+    {
+        const auto target = toUnitVector(azimuth, elevation);
+        size_t best = 0;
+        float bestDot = -2.0f;
+
+        for (size_t i = 0; i < measurements.size(); ++i)
+        {
+            const float dot = target * toUnitVector(measurements[i].azimuth, measurements[i].elevation);
+            if (dot > bestDot)
+            {
+                bestDot = dot;
+                best = i;
+            }
+        }
+
+        return measurements[best];
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.size() < 2)
+    {
+        std::cerr << "usage: HrtfBuilder <wav directory> <output.brht> [--rate=48000] [--length=256]\n"
+                     "                   [--az-step=5] [--el-min=-40] [--el-max=90] [--el-step=10]\n";
+        return 1;
+    }
+
+    auto option = [&args](const char* name, double fallback)
+    {
+        const auto value = args.getValueForOption(name);
+        return value.isNotEmpty() ? value.getDoubleValue() : fallback;
+    };
+
+    const double sampleRate = option("--rate", 48000.0);
+    const int length = (int)option("--length", 256.0);
+    const float azimuthStep = (float)option("--az-step", 5.0);
+    const float elevationMin = (float)option("--el-min", -40.0);
+    const float elevationMax = (float)option("--el-max", 90.0);
+    const float elevationStep = (float)option("--el-step", 10.0);
+
+    const auto workingDirectory = juce::File::getCurrentWorkingDirectory();
+    const auto sourceDirectory = workingDirectory.getChildFile(args[0].text);
+    const auto output = workingDirectory.getChildFile(args[1].text);
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::vector<Measurement> measurements;
+
+    for (const auto& file : sourceDirectory.findChildFiles(juce::File::findFiles, false, "*.wav"))
+    {
+        Measurement measurement;
+        if (readMeasurement(formats, file, sampleRate, length, measurement))
+            measurements.push_back(std::move(measurement));
+        else
+            std::cerr << "skipping " << file.getFileName() << "\n";
+    }
+
+    if (measurements.empty())
+    {
+        std::cerr << "no measurements found in " << sourceDirectory.getFullPathName() << "\n";
+        return 1;
+    }
+
+    // Same partitioning the plugin prepares its convolvers with at this rate
+    const int partitionSize = HrtfSet::getPartitionSize(sampleRate);
+    const int numHeadPartitions = HrtfSet::headPartitions;
+    const int headLength = partitionSize * numHeadPartitions;
+    const int numTailPartitions = length > headLength ? (length - headLength + headLength - 1) / headLength : 0;
+
+    const int numAzimuths = juce::jmax(1, juce::roundToInt(360.0f / azimuthStep));
+    const int numElevations = juce::jmax(1, (int)std::floor((elevationMax - elevationMin) / elevationStep) + 1);
+
+    const auto header = HrtfDatabase::makeHeader(sampleRate, partitionSize, numHeadPartitions, numTailPartitions,
+                                                 numAzimuths, numElevations, elevationMin, elevationStep);
+    const int filterSize = HrtfDatabase::getFilterSize(header);
+    const int headSize = numHeadPartitions * UniformConvolver::getSpectrumSize(partitionSize);
+
+    std::vector<float> spectra((size_t)filterSize * 2 * (size_t)numAzimuths * (size_t)numElevations, 0.0f);
+    float* dest = spectra.data();
+
+    // Each grid direction takes the nearest measured one
+    for (int e = 0; e < numElevations; ++e)
+    {
+        for (int a = 0; a < numAzimuths; ++a)
+        {
+            const auto& nearest = findNearest(measurements, 360.0f * (float)a / (float)numAzimuths, elevationMin + elevationStep * (float)e);
+
+            for (int ear = 0; ear < 2; ++ear, dest += filterSize)
+            {
+                const float* impulse = nearest.impulse.getReadPointer(ear);
+                UniformConvolver::computeSpectra(impulse, juce::jmin(length, headLength), partitionSize, dest);
+
+                if (numTailPartitions > 0)
+                    UniformConvolver::computeSpectra(impulse + headLength, length - headLength, headLength, dest + headSize);
+            }
+        }
+    }
+
+    if (!HrtfDatabase::write(output, header, spectra.data()))
+    {
+        std::cerr << "couldn't write " << output.getFullPathName() << "\n";
+        return 1;
+    }
+
+    std::cout << "wrote " << output.getFullPathName() << ": " << measurements.size() << " measurements onto "
+              << numAzimuths << " x " << numElevations << " directions, " << partitionSize << " sample partitions\n";
+    return 0;
+}
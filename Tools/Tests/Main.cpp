@@ -0,0 +1,39 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 18 Oct 2026 9:14:36am
+    Author:  Carlos
+
+    Headless tests of the behaviour the engine promises, one file per part of
+    it: the voice pool, sample-accurate MIDI and so on. Runs every
+    juce::UnitTest in the "Binaural Rays" category and exits with 1 if any of
+    them failed, which is what ctest checks. The allocation guard is always on
+    here, so anything that allocates under a ScopedGuard aborts the run.
+
+        BinauralRaysTests [--seed=<n>]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    const juce::ArgumentList args(argc, argv);
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+
+    if (args.containsOption("--seed"))
+        runner.runTestsInCategory("Binaural Rays", args.getValueForOption("--seed").getLargeIntValue());
+    else
+        runner.runTestsInCategory("Binaural Rays");
+
+    int failures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        failures += runner.getResult(i)->failures;
+
+    return failures > 0 ? 1 : 0;
+}
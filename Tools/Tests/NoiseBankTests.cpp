@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    NoiseBankTests.cpp
+    Created: 18 Oct 2026 9:14:36am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/NoiseBank.h"
+
+namespace
+{
+    constexpr int numVoices = 8;
+    constexpr int blockSize = 64;
+    constexpr int numBlocks = 32;
+
+    // Every voice's noise for numBlocks blocks, each block rendered in the given slices,
+    // the voices in the given order. One row per voice.
+    std::vector<std::vector<float>> renderNoise(NoiseBank::Colour colour, juce::uint32 seed,
+                                                const std::vector<int>& slices, const std::vector<int>& order)
+    {
+        NoiseBank bank(numVoices);
+        bank.prepare(48000.0, blockSize);
+        bank.setColour(colour);
+        bank.setSeed(seed);
+
+        for (int v = 0; v < numVoices; ++v)
+            bank.setCentreFrequency(v, 200.0f * (float)(v + 1));
+
+        std::vector<std::vector<float>> result((size_t)numVoices);
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            int start = 0;
+            for (const int slice : slices)
+            {
+                bank.render(order.data(), (int)order.size(), start, slice);
+                start += slice;
+            }
+
+            jassert(start == blockSize);
+
+            for (int v = 0; v < numVoices; ++v)
+                result[(size_t)v].insert(result[(size_t)v].end(), bank.getOutput(v), bank.getOutput(v) + blockSize);
+        }
+
+        return result;
+    }
+}
+
+class NoiseBankTests : public juce::UnitTest
+{
+public:
+    NoiseBankTests() : juce::UnitTest("NoiseBank", "Binaural Rays") {}
+
+    void runTest() override
+    {
+        std::vector<int> ascending(numVoices), descending(numVoices);
+        for (int v = 0; v < numVoices; ++v)
+        {
+            ascending[(size_t)v] = v;
+            descending[(size_t)v] = numVoices - 1 - v;
+        }
+
+        for (const auto colour : { NoiseBank::Colour::white, NoiseBank::Colour::pink,
+                                   NoiseBank::Colour::brown, NoiseBank::Colour::band })
+        {
+            beginTest("Colour " + juce::String((int)colour) + " is the same whatever the block splits");
+
+            const auto whole = renderNoise(colour, 1234, { blockSize }, ascending);
+
+            expect(whole == renderNoise(colour, 1234, { 1, 7, 16, 40 }, ascending), "split blocks");
+            expect(whole == renderNoise(colour, 1234, { 33, 31 }, descending), "split blocks, voices reversed");
+
+            // One voice rendered on its own matches the same voice in the group
+            const auto alone = renderNoise(colour, 1234, { 5, 59 }, { 3 });
+            expect(whole[3] == alone[3], "a voice rendered on its own");
+
+            beginTest("Colour " + juce::String((int)colour) + " depends on the seed");
+
+            const auto other = renderNoise(colour, 1235, { blockSize }, ascending);
+            expect(whole[0] != other[0], "another seed");
+            expect(whole[0] != whole[1], "voices of the same seed");
+
+            float peak = 0.0f;
+            for (const auto& voice : whole)
+                for (const float sample : voice)
+                    peak = juce::jmax(peak, std::abs(sample));
+
+            expect(peak > 0.05f && peak < 4.0f, "level " + juce::String(peak));
+        }
+    }
+};
+
+static NoiseBankTests noiseBankTests;
@@ -0,0 +1,223 @@
+/*
+  ==============================================================================
+
+    PluginStateTests.cpp
+    Created: 18 Oct 2026 9:14:36am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <limits>
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    PluginState makeState()
+    {
+        PluginState state;
+        state.parameters = { { "gain", 0.25f }, { "waveform", 2.0f }, { "dimension", 3.5f } };
+        state.scene.numSources = 3;
+        state.scene.positions[0] = { 10.0f, 20.0f };
+        state.scene.positions[1] = { 30.0f, 40.0f };
+        state.scene.positions[2] = { 99.0f, 1.0f };
+        state.splinePoints = { { -0.5f, 0.5f }, { 0.5f, 0.5f }, { 0.0f, -0.75f } };
+        return state;
+    }
+
+    juce::MemoryBlock toBytes(const PluginState& state)
+    {
+        juce::MemoryOutputStream output;
+        state.write(output);
+        return output.getMemoryBlock();
+    }
+
+    bool sameScene(const PluginState& a, const PluginState& b)
+    {
+        if (a.scene.numSources != b.scene.numSources || a.splinePoints != b.splinePoints)
+            return false;
+
+        for (int s = 0; s < a.scene.numSources; ++s)
+            if (a.scene.positions[(size_t)s] != b.scene.positions[(size_t)s])
+                return false;
+
+        return true;
+    }
+
+    // Parameters that went through a processor are snapped to their ranges, so they
+    // only come back within tolerance
+    bool same(const PluginState& a, const PluginState& b, float tolerance = 0.0f)
+    {
+        if (a.parameters.size() != b.parameters.size() || !sameScene(a, b))
+            return false;
+
+        for (size_t i = 0; i < a.parameters.size(); ++i)
+            if (a.parameters[i].id != b.parameters[i].id || std::abs(a.parameters[i].value - b.parameters[i].value) > tolerance)
+                return false;
+
+        return true;
+    }
+
+    float findParameter(const PluginState& state, const juce::String& id)
+    {
+        for (const auto& parameter : state.parameters)
+            if (parameter.id == id)
+                return parameter.value;
+
+        return -1.0f;
+    }
+}
+
+class PluginStateTests : public juce::UnitTest
+{
+public:
+    PluginStateTests() : juce::UnitTest("PluginState", "Binaural Rays") {}
+
+    void runTest() override
+    {
+        beginTest("A state reads back as it was written");
+        {
+            const auto state = makeState();
+            const auto bytes = toBytes(state);
+
+            PluginState read;
+            expect(read.read(bytes.getData(), bytes.getSize()));
+            expect(same(state, read));
+        }
+
+        beginTest("A newer version's state is read up to what this version knows");
+        {
+            const auto state = makeState();
+            const auto bytes = toBytes(state);
+
+            // Same sections under a higher version number, then one this version has never seen
+            juce::MemoryOutputStream newer;
+            newer.writeInt((int)PluginState::magic);
+            newer.writeInt((int)PluginState::currentVersion + 1);
+            newer.write(static_cast<const char*>(bytes.getData()) + 8, bytes.getSize() - 8);
+            newer.writeCompressedInt(2);
+            newer.writeString("a section from the future");
+            newer.writeDouble(1.0);
+
+            PluginState read;
+            expect(read.read(newer.getData(), newer.getDataSize()));
+            expect(same(state, read));
+        }
+
+        beginTest("Anything that isn't a state is rejected and changes nothing");
+        {
+            const auto state = makeState();
+            auto bytes = toBytes(state);
+
+            PluginState read = state;
+            expect(!read.read(nullptr, 0));
+            expect(!read.read("<xml/>", 6));
+
+            static_cast<char*>(bytes.getData())[0] ^= 0x20;
+            expect(!read.read(bytes.getData(), bytes.getSize()), "wrong magic");
+
+            // An impossible source count
+            juce::MemoryOutputStream corrupt;
+            corrupt.writeInt((int)PluginState::magic);
+            corrupt.writeInt((int)PluginState::currentVersion);
+            corrupt.writeCompressedInt(0);
+            corrupt.writeCompressedInt(SceneSnapshot::maxSources + 1);
+            expect(!read.read(corrupt.getData(), corrupt.getDataSize()), "too many sources");
+
+            expect(same(state, read));
+        }
+
+        beginTest("A state cut short anywhere is rejected");
+        {
+            const auto state = makeState();
+            const auto bytes = toBytes(state);
+
+            int accepted = 0;
+            for (size_t size = 0; size < bytes.getSize(); ++size)
+            {
+                PluginState read = state;
+                if (read.read(bytes.getData(), size) || !same(state, read))
+                    ++accepted;
+            }
+
+            expectEquals(accepted, 0);
+        }
+
+        beginTest("Values that aren't finite numbers are rejected");
+        {
+            const auto nan = std::numeric_limits<float>::quiet_NaN();
+            const auto infinity = std::numeric_limits<float>::infinity();
+
+            auto badParameter = makeState();
+            badParameter.parameters[0].value = nan;
+
+            auto badPosition = makeState();
+            badPosition.scene.positions[1].x = infinity;
+
+            auto badPoint = makeState();
+            badPoint.splinePoints[2].y = -infinity;
+
+            for (const auto* bad : { &badParameter, &badPosition, &badPoint })
+            {
+                const auto bytes = toBytes(*bad);
+                PluginState read = makeState();
+                expect(!read.read(bytes.getData(), bytes.getSize()));
+                expect(same(makeState(), read));
+            }
+        }
+
+        beginTest("The processor's session state round trips");
+        {
+            TapSynthAudioProcessor source;
+            setPlain(source, "gain", 0.25f);
+            setPlain(source, "dimension", 3.5f);
+            setPlain(source, "trajectory", 4.0f);
+
+            auto scene = makeState().scene;
+            source.publishScene(scene);
+
+            const auto points = makeState().splinePoints;
+            source.setTrajectoryPoints(points.data(), (int)points.size());
+
+            juce::MemoryBlock bytes;
+            source.getStateInformation(bytes);
+
+            TapSynthAudioProcessor destination;
+            destination.setStateInformation(bytes.getData(), (int)bytes.getSize());
+
+            const auto recalled = destination.captureState();
+            expect(same(source.captureState(), recalled, 1.0e-4f));
+            expectWithinAbsoluteError(findParameter(recalled, "gain"), 0.25f, 1.0e-4f);
+            expectWithinAbsoluteError(findParameter(recalled, "dimension"), 3.5f, 1.0e-4f);
+        }
+
+        beginTest("Parameters a state doesn't know go to their defaults, unknown ones are ignored");
+        {
+            auto state = makeState();
+            state.parameters = { { "dimension", 3.5f }, { "aParameterFromTheFuture", 12.0f } };
+            const auto bytes = toBytes(state);
+
+            TapSynthAudioProcessor processor;
+            setPlain(processor, "gain", 0.9f);
+            processor.setStateInformation(bytes.getData(), (int)bytes.getSize());
+
+            const auto recalled = processor.captureState();
+            const auto* gain = processor.getState().getParameter("gain");
+
+            expectWithinAbsoluteError(findParameter(recalled, "dimension"), 3.5f, 1.0e-4f);
+            expectWithinAbsoluteError(findParameter(recalled, "gain"), gain->convertFrom0to1(gain->getDefaultValue()), 1.0e-4f);
+            expectEquals(findParameter(recalled, "aParameterFromTheFuture"), -1.0f);
+            expect(sameScene(state, recalled));
+        }
+    }
+
+private:
+    static void setPlain(TapSynthAudioProcessor& processor, const char* parameterID, float value)
+    {
+        if (auto* parameter = processor.getState().getParameter(parameterID))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+};
+
+static PluginStateTests pluginStateTests;
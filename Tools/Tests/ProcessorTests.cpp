@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    ProcessorTests.cpp
+    Created: 18 Oct 2026 10:02:51am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+    constexpr int numBlocks = 24;
+
+    // The processor's left output for numBlocks host blocks, with one extra note-on at
+    // noteOffset of the first block, or none when it's negative. The sequencer and the
+    // note played on start are the same in every render, so subtracting a render
+    // without the note leaves only the note.
+    std::vector<float> render(int noteOffset)
+    {
+        TapSynthAudioProcessor processor;
+        processor.setPlayConfigDetails(0, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        midi.ensureSize(256);
+
+        std::vector<float> output;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            midi.clear();
+            if (block == 0 && noteOffset >= 0)
+                midi.addEvent(juce::MidiMessage::noteOn(2, 60, 0.8f), noteOffset);
+
+            buffer.clear();
+            processor.processBlock(buffer, midi);
+            output.insert(output.end(), buffer.getReadPointer(0), buffer.getReadPointer(0) + blockSize);
+        }
+
+        return output;
+    }
+
+    std::vector<float> subtract(const std::vector<float>& a, const std::vector<float>& b)
+    {
+        std::vector<float> result(a.size());
+        for (size_t i = 0; i < a.size(); ++i)
+            result[i] = a[i] - b[i];
+
+        return result;
+    }
+
+    int findOnset(const std::vector<float>& signal)
+    {
+        for (size_t i = 0; i < signal.size(); ++i)
+            if (std::abs(signal[i]) > 1.0e-6f)
+                return (int)i;
+
+        return -1;
+    }
+}
+
+class ProcessorTests : public juce::UnitTest
+{
+public:
+    ProcessorTests() : juce::UnitTest("TapSynthAudioProcessor", "Binaural Rays") {}
+
+    void runTest() override
+    {
+        beginTest("A note-on at the start of a host block sounds");
+
+        const auto withoutNote = render(-1);
+        const auto atStart = subtract(render(0), withoutNote);
+        const int startOnset = findOnset(atStart);
+
+        expect(startOnset >= 0, "the note sounds");
+
+        // 100 is in the middle of the second micro-block of a 256 sample host block, 200
+        // in the fourth. A note played early, or played again by a later micro-block,
+        // doesn't sound like the one at the start moved along.
+        for (const int offset : { 100, 200 })
+        {
+            beginTest("A note-on at sample " + juce::String(offset) + " of a host block starts there, once");
+
+            const auto delayed = subtract(render(offset), withoutNote);
+            expectEquals(findOnset(delayed) - startOnset, offset);
+
+            float largestError = 0.0f;
+            for (size_t i = 0; i + (size_t)offset < delayed.size(); ++i)
+                largestError = juce::jmax(largestError, std::abs(delayed[i + (size_t)offset] - atStart[i]));
+
+            expect(largestError < 1.0e-3f, "differs from the note at the start by " + juce::String(largestError));
+        }
+    }
+};
+
+static ProcessorTests processorTests;
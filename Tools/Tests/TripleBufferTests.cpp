@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    TripleBufferTests.cpp
+    Created: 18 Oct 2026 9:14:36am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <thread>
+#include "../../Source/TripleBuffer.h"
+#include "../../Source/SceneSnapshot.h"
+
+class TripleBufferTests : public juce::UnitTest
+{
+public:
+    TripleBufferTests() : juce::UnitTest("TripleBuffer", "Binaural Rays") {}
+
+    void runTest() override
+    {
+        beginTest("Nothing is there before the first publish");
+        {
+            TripleBuffer<int> buffer;
+            expect(!buffer.update());
+
+            buffer.getWriteBuffer() = 7;
+            buffer.publish();
+            expect(buffer.update());
+            expectEquals(buffer.getReadBuffer(), 7);
+            expect(!buffer.update(), "read twice");
+            expectEquals(buffer.getReadBuffer(), 7);
+        }
+
+        beginTest("Only the latest of several publishes is read");
+        {
+            TripleBuffer<int> buffer;
+            for (int i = 1; i <= 5; ++i)
+            {
+                buffer.getWriteBuffer() = i;
+                buffer.publish();
+            }
+
+            expect(buffer.update());
+            expectEquals(buffer.getReadBuffer(), 5);
+        }
+
+        beginTest("Scenes written on one thread are never read torn on another");
+        {
+            // Every position of scene n is (n, n), so a torn read has two different n.
+            // The writer fills all of its buffer every time, as the writer side requires.
+            constexpr int numScenes = 200000;
+            TripleBuffer<SceneSnapshot> buffer;
+            std::atomic<bool> done { false };
+
+            std::thread writer([&]
+            {
+                for (int n = 1; n <= numScenes; ++n)
+                {
+                    auto& scene = buffer.getWriteBuffer();
+                    scene.numSources = SceneSnapshot::maxSources;
+                    scene.positions.fill({ (float)n, (float)n });
+                    buffer.publish();
+                }
+
+                done.store(true);
+            });
+
+            int reads = 0, torn = 0, backwards = 0;
+            float last = 0.0f;
+
+            for (bool finished = false; !finished;)
+            {
+                finished = done.load();
+
+                if (!buffer.update())
+                    continue;
+
+                const auto& scene = buffer.getReadBuffer();
+                const float n = scene.positions[0].x;
+
+                for (const auto& position : scene.positions)
+                    if (position.x != n || position.y != n)
+                        ++torn;
+
+                if (n < last)
+                    ++backwards;
+
+                last = n;
+                ++reads;
+            }
+
+            writer.join();
+
+            expect(reads > 0);
+            expectEquals(torn, 0);
+            expectEquals(backwards, 0);
+            expectEquals(last, (float)numScenes, "the last scene is the one left to read");
+        }
+    }
+};
+
+static TripleBufferTests tripleBufferTests;
@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    VoicePoolTests.cpp
+    Created: 18 Oct 2026 11:20:44am
+    Author:  Carlos
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/TapSynthesiser.h"
+#include "../../Source/SynthSound.h"
+#include "../../Source/AudioThreadGuard.h"
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 64;
+    constexpr int numVoices = SpatialVoiceState::minVoices;
+
+    // The synth and everything its voices render into, wired like the processor's
+    struct VoicePool
+    {
+        VoicePool()
+        {
+            synth.addSound(new SynthSound());
+
+            for (int i = 0; i < numVoices; ++i)
+                synth.addSynthVoice(new SynthVoice(i, spatialState, oscillators, noise, modulation));
+
+            synth.setCurrentPlaybackSampleRate(sampleRate);
+            for (auto* voice : synth.getSynthVoices())
+                voice->prepareToPlay(sampleRate, blockSize);
+
+            oscillators.prepare(sampleRate, blockSize);
+            noise.prepare(sampleRate, blockSize);
+            modulation.prepare(sampleRate, blockSize);
+            spatialState.prepare(sampleRate, blockSize, 10.0f);
+            output.setSize(2, blockSize);
+            frequencies.assign((size_t)blockSize, 440.0f);
+        }
+
+        void render(const juce::MidiBuffer& midi) noexcept
+        {
+            spatialState.clearVoiceBuffers(blockSize);
+            modulation.setParameters(frequencies.data(), frequencies.data(), 1.0f, ModulationEngine::Shape::sine);
+            synth.renderNextBlock(output, midi, 0, blockSize);
+        }
+
+        int getNumActive() const noexcept
+        {
+            int numActive = 0;
+            for (auto* voice : synth.getSynthVoices())
+                numActive += voice->isVoiceActive() ? 1 : 0;
+
+            return numActive;
+        }
+
+        bool isPlaying(int note) const noexcept
+        {
+            for (auto* voice : synth.getSynthVoices())
+                if (voice->isVoiceActive() && voice->getCurrentlyPlayingNote() == note)
+                    return true;
+
+            return false;
+        }
+
+        SpatialVoiceState spatialState { numVoices };
+        WavetableOscillatorBank oscillators { numVoices };
+        NoiseBank noise { numVoices };
+        ModulationEngine modulation { numVoices };
+        TapSynthesiser synth { oscillators, noise };
+        std::vector<float> frequencies;     // a steady sweep, both limits the same
+        juce::AudioBuffer<float> output;
+    };
+}
+
+class VoicePoolTests : public juce::UnitTest
+{
+public:
+    VoicePoolTests() : juce::UnitTest("Voice pool", "Binaural Rays") {}
+
+    void runTest() override
+    {
+        VoicePool pool;
+
+        // Built before the guard goes up, the way the host hands its MIDI in
+        juce::MidiBuffer chord, release, lateNote, nothing;
+        for (int n = 0; n <= numVoices; ++n)
+        {
+            chord.addEvent(juce::MidiMessage::noteOn(1, 40 + n, 0.8f), n);
+            release.addEvent(juce::MidiMessage::noteOff(1, 40 + n), 0);
+        }
+
+        lateNote.addEvent(juce::MidiMessage::noteOn(1, 90, 0.8f), 10);
+
+        const int releaseBlocks = (int)std::ceil(0.2 * sampleRate / blockSize);
+        int activeAfterChord = 0, activeAfterRelease = 0, activeAfterLateNote = 0;
+        bool lastNotePlaying = false, lateNotePlaying = false;
+
+        {
+            // Every note, steal and release happens with the allocation guard up, which
+            // aborts the whole run if anything on the way allocates
+            AudioThreadGuard::ScopedGuard realtimeGuard;
+
+            pool.render(chord);
+            activeAfterChord = pool.getNumActive();
+            lastNotePlaying = pool.isPlaying(40 + numVoices);
+
+            pool.render(release);
+            for (int block = 0; block < releaseBlocks; ++block)
+                pool.render(nothing);
+
+            activeAfterRelease = pool.getNumActive();
+
+            pool.render(lateNote);
+            activeAfterLateNote = pool.getNumActive();
+            lateNotePlaying = pool.isPlaying(90);
+        }
+
+        beginTest("One note more than there are voices steals one");
+        expectEquals(activeAfterChord, numVoices);
+        expect(lastNotePlaying, "the newest note got a voice");
+
+        beginTest("Released voices go back to the pool");
+        expectEquals(activeAfterRelease, 0);
+        expectEquals(activeAfterLateNote, 1);
+        expect(lateNotePlaying);
+
+        beginTest("Nothing allocates while notes come and go");
+        expect(BINAURAL_RAYS_ALLOCATION_GUARD != 0, "the test target builds with the guard on");
+    }
+};
+
+static VoicePoolTests voicePoolTests;